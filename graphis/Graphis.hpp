@@ -4,15 +4,22 @@
 \*---------------------------------------------------------------------------*/
 #pragma once
 
+#include "GraphisHeap.hpp"
+#include "GraphisParallel.hpp"
+
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <limits>
 #include <list>
 #include <map>
 #include <queue>
 #include <set>
 #include <stack>
+#include <stdexcept>
 #include <vector>
 
 /// \struct AdjacencyNode
@@ -32,9 +39,151 @@ struct AdjacencyNode {
     int weight;
 };
 
+using VertexId = std::uint32_t;
+using EdgeOffset = std::uint64_t;
+
+/// Id returned for keys that are not vertices of a graph
+constexpr VertexId kNoVertex = std::numeric_limits<VertexId>::max();
+
+/// Distance reported for vertices that cannot be reached
+constexpr int kUnreachable = std::numeric_limits<int>::max();
+
+/// \struct AdjacencyArc
+/// \brief  Edge as stored internally, with its destination interned as a VertexId
+struct AdjacencyArc {
+    VertexId dest;
+    int weight;
+};
+
+/// \class  ArcRange
+/// \brief  Non-owning view of one vertex's stored arcs, newest first like GetAdjacencyList.
+///         Arcs tombstoned by a removal (dest == kNoVertex) are stepped over.
+class ArcRange {
+public:
+    /// \class  iterator
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = AdjacencyArc;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const AdjacencyArc*;
+        using reference = const AdjacencyArc&;
+
+        ///
+        iterator(const AdjacencyArc* first, const AdjacencyArc* last)
+                : m_first(first), m_last(last) {
+            SkipTombstones();
+        }
+
+        ///
+        reference operator*() const {
+            return m_last[-1];
+        }
+
+        ///
+        pointer operator->() const {
+            return m_last - 1;
+        }
+
+        ///
+        iterator& operator++() {
+            --m_last;
+            SkipTombstones();
+            return *this;
+        }
+
+        ///
+        bool operator!=(const iterator& rhs) const {
+            return m_last != rhs.m_last;
+        }
+
+        ///
+        bool operator==(const iterator& rhs) const {
+            return m_last == rhs.m_last;
+        }
+
+    private:
+        ///
+        void SkipTombstones() {
+            while ((m_last != m_first) && (m_last[-1].dest == kNoVertex)) {
+                --m_last;
+            }
+        }
+
+        const AdjacencyArc* m_first;
+        const AdjacencyArc* m_last;
+    };
+
+    ///
+    ArcRange(const AdjacencyArc* first, const AdjacencyArc* last)
+            : ArcRange(first, last, last - first) {}
+
+    ///
+    /// \brief  size is the number of live arcs in [first, last)
+    ArcRange(const AdjacencyArc* first, const AdjacencyArc* last, std::size_t size)
+            : m_first(first), m_last(last), m_size(size) {}
+
+    ///
+    iterator begin() const {
+        return iterator(m_first, m_last);
+    }
+
+    ///
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    ///
+    iterator end() const {
+        return iterator(m_first, m_first);
+    }
+
+    ///
+    std::size_t size() const {
+        return m_size;
+    }
+
+private:
+    const AdjacencyArc* m_first;
+    const AdjacencyArc* m_last;
+    std::size_t m_size;
+};
+
 /// \enum   VisitedState
 enum class VisitedState { VS_UNDISCOVERD, VS_DISCOVERED, VS_PROCESSED };
 
+/// \enum   QueueKind
+/// \brief  Priority queue used by shortest path searches; the radix heap requires non-negative
+///         weights
+enum class QueueKind { QK_BINARY_HEAP, QK_RADIX_HEAP };
+
+/// \enum   ComponentKind
+/// \brief  Parallel connected components strategy: link every edge into a concurrent
+///         union-find, or Afforest's neighbor sampling, which skips most edges of the largest
+///         component
+enum class ComponentKind { CK_UNION_FIND, CK_AFFOREST };
+
+/// \enum   SpanningKind
+/// \brief  Minimum spanning forest engine: heap-based Prim suits dense graphs, Kruskal sparse
+///         ones, and Boruvka runs its rounds in parallel
+enum class SpanningKind { SK_PRIM, SK_KRUSKAL, SK_BORUVKA };
+
+/// \enum   AllPairsKind
+/// \brief  All-pairs shortest path engine: cache-blocked Floyd-Warshall suits dense graphs,
+///         Johnson's per-source Dijkstra, run in parallel, sparse ones
+enum class AllPairsKind { AK_FLOYD_WARSHALL, AK_JOHNSON };
+
+/// \enum   StrongKind
+/// \brief  Strongly connected components engine: iterative Tarjan in one pass, or trimming
+///         followed by parallel forward-backward splitting for large graphs
+enum class StrongKind { SC_TARJAN, SC_FORWARD_BACKWARD };
+
+/// \enum   ReorderKind
+/// \brief  Vertex relabeling for GraphisCSR::Reorder: hubs first by degree, reverse
+///         Cuthill-McKee's narrow band of BFS levels, or Gorder's greedy packing of vertices
+///         that share neighbors into the same window of ids
+enum class ReorderKind { RK_DEGREE, RK_REVERSE_CUTHILL_MCKEE, RK_GORDER };
+
 /// \enum   EdgeClassification
 enum class EdgeClassification {
     EC_TREE,
@@ -47,6 +196,12 @@ enum class EdgeClassification {
 template<typename DataT>
 class Graphis;
 
+template<typename DataT>
+class GraphisCSR;
+
+template<typename DataT>
+class DynamicShortestPath;
+
 template<typename DataT>
 using AdjacencyList = std::list<AdjacencyNode<DataT>>;
 
@@ -71,12 +226,349 @@ using ComponentList = std::map<int, std::vector<DataT>>;
 template<typename DataT>
 using EntryList = std::map<DataT, std::pair<int, int>>;
 
+/// \struct PathResult
+template<typename DataT>
+struct PathResult {
+    ///
+    PathResult() : distance(kUnreachable), settled(0) {}
+
+    std::vector<DataT> path;
+    int distance;
+    std::size_t settled;
+};
+
+/// \struct WeightedEdge
+template<typename DataT>
+struct WeightedEdge {
+    ///
+    bool operator==(const WeightedEdge<DataT>& rhs) const {
+        return (src == rhs.src) && (dst == rhs.dst) && (weight == rhs.weight);
+    }
+
+    DataT src;
+    DataT dst;
+    int weight;
+};
+
+/// \struct SpanningTree
+/// \brief  Minimum spanning forest: one tree per connected component, and its total weight
+template<typename DataT>
+struct SpanningTree {
+    ///
+    SpanningTree() : weight(0) {}
+
+    std::vector<WeightedEdge<DataT>> edges;
+    std::int64_t weight;
+};
+
+/// \class  DistanceMatrix
+/// \brief  All-pairs distances in one contiguous row-major block: the distance from vertex
+///         src to vertex dst is at src * GetNumVerts() + dst, and kUnreachable marks pairs with
+///         no path
+class DistanceMatrix {
+public:
+    ///
+    explicit DistanceMatrix(std::size_t num_verts = 0)
+            : m_num_verts(num_verts), m_distances(num_verts * num_verts, kUnreachable) {}
+
+    ///
+    int At(std::size_t src, std::size_t dst) const {
+        return m_distances[src * m_num_verts + dst];
+    }
+
+    ///
+    const int* GetData() const {
+        return m_distances.data();
+    }
+
+    ///
+    int* GetData() {
+        return m_distances.data();
+    }
+
+    ///
+    std::size_t GetNumVerts() const {
+        return m_num_verts;
+    }
+
+    ///
+    const int* GetRow(std::size_t src) const {
+        return m_distances.data() + src * m_num_verts;
+    }
+
+private:
+    std::size_t m_num_verts;
+    std::vector<int> m_distances;
+};
+
 template<typename DataT>
 using ProcVertexFn = void (*)(Graphis<DataT>&, DataT);
 
 template<typename DataT>
 using ProcEdgeFn = void (*)(Graphis<DataT>&, DataT, DataT);
 
+/// \class  VertexTable
+/// \brief  Interns vertex keys as dense ids 0..n-1, in order of first appearance
+template<typename DataT>
+class VertexTable {
+public:
+    ///
+    VertexId Find(const DataT& key) const {
+        auto idit = m_ids.find(key);
+        if (idit == m_ids.end()) {
+            return kNoVertex;
+        }
+
+        return idit->second;
+    }
+
+    ///
+    const DataT& GetKey(VertexId vertex) const {
+        return m_keys[vertex];
+    }
+
+    ///
+    /// \brief  Ids ordered by their keys, matching the order of Graphis::GetVertexList
+    std::vector<VertexId> GetOrderedIds() const {
+        std::vector<VertexId> ordered;
+        ordered.reserve(m_keys.size());
+        for (const auto& entry : m_ids) {
+            ordered.push_back(entry.second);
+        }
+
+        return ordered;
+    }
+
+    ///
+    /// \brief  Drops the ids of removed keys and renumbers the rest densely, keeping their
+    ///         relative order; returns the new id of every old id, kNoVertex for removed ones
+    std::vector<VertexId> Compact() {
+        std::vector<VertexId> renumbered(m_keys.size(), kNoVertex);
+        for (const auto& entry : m_ids) {
+            renumbered[entry.second] = 0;
+        }
+
+        VertexId next = 0;
+        for (VertexId vert = 0; vert < m_keys.size(); ++vert) {
+            if (renumbered[vert] != kNoVertex) {
+                m_keys[next] = m_keys[vert];
+                renumbered[vert] = next++;
+            }
+        }
+
+        m_keys.resize(next);
+        for (auto& entry : m_ids) {
+            entry.second = renumbered[entry.second];
+        }
+
+        return renumbered;
+    }
+
+    ///
+    /// \brief  Returns the id of key, assigning the next free id on first sight
+    VertexId Intern(const DataT& key) {
+        auto inserted = m_ids.insert(std::make_pair(key, static_cast<VertexId>(m_keys.size())));
+        if (inserted.second) {
+            m_keys.push_back(key);
+        }
+
+        return inserted.first->second;
+    }
+
+    ///
+    /// \brief  Forgets key; its id stays allocated, unused, until Compact
+    void Remove(const DataT& key) {
+        m_ids.erase(key);
+    }
+
+    ///
+    std::size_t Size() const {
+        return m_keys.size();
+    }
+
+private:
+    std::map<DataT, VertexId> m_ids;
+    std::vector<DataT> m_keys;
+};
+
+/// \struct Neighbor
+/// \brief  What a NeighborRange yields: a reference to the stored key, and the edge weight
+template<typename DataT>
+struct Neighbor {
+    const DataT& dest;
+    int weight;
+};
+
+/// \class  NeighborRange
+/// \brief  Allocation-free replacement for GetAdjacencyList; valid until the graph is modified
+template<typename DataT>
+class NeighborRange {
+public:
+    /// \class  Iterator
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Neighbor<DataT>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Neighbor<DataT>;
+
+        ///
+        Iterator(ArcRange::iterator arc, const VertexTable<DataT>* vertices)
+                : m_arc(arc), m_vertices(vertices) {}
+
+        ///
+        Neighbor<DataT> operator*() const {
+            return Neighbor<DataT>{m_vertices->GetKey(m_arc->dest), m_arc->weight};
+        }
+
+        ///
+        Iterator& operator++() {
+            ++m_arc;
+            return *this;
+        }
+
+        ///
+        bool operator!=(const Iterator& rhs) const {
+            return m_arc != rhs.m_arc;
+        }
+
+        ///
+        bool operator==(const Iterator& rhs) const {
+            return m_arc == rhs.m_arc;
+        }
+
+    private:
+        ArcRange::iterator m_arc;
+        const VertexTable<DataT>* m_vertices;
+    };
+
+    ///
+    NeighborRange(ArcRange arcs, const VertexTable<DataT>* vertices)
+            : m_arcs(arcs), m_vertices(vertices) {}
+
+    ///
+    Iterator begin() const {
+        return Iterator(m_arcs.begin(), m_vertices);
+    }
+
+    ///
+    bool empty() const {
+        return m_arcs.empty();
+    }
+
+    ///
+    Iterator end() const {
+        return Iterator(m_arcs.end(), m_vertices);
+    }
+
+    ///
+    std::size_t size() const {
+        return m_arcs.size();
+    }
+
+private:
+    ArcRange m_arcs;
+    const VertexTable<DataT>* m_vertices;
+};
+
+/// \class  SearchContext
+/// \brief  Visit state of one search: parents, visited flags, entry/exit times and the
+///         termination flag. The const Graphis searches write only to the context they are
+///         given, so one graph can serve concurrent queries with a context per thread; reusing
+///         a context across queries reuses its storage.
+template<typename DataT>
+class SearchContext {
+    friend class Graphis<DataT>;
+
+public:
+    ///
+    SearchContext() : m_terminate(false), m_time(0) {}
+
+    ///
+    bool IsTerminated() const {
+        return m_terminate;
+    }
+
+    ///
+    /// \brief  Setting the flag from a hook abandons the depth-first search in progress
+    void SetTerminationFlag(bool terminate) {
+        m_terminate = terminate;
+    }
+
+private:
+    ///
+    void Reset(std::size_t num_vertices) {
+        ResetParents(num_vertices);
+        m_terminate = false;
+        m_time = 0;
+        m_discovered.assign(num_vertices, VisitedState::VS_UNDISCOVERD);
+        m_timeclock.assign(num_vertices, std::make_pair(0, 0));
+    }
+
+    ///
+    void ResetParents(std::size_t num_vertices) {
+        m_parents.assign(num_vertices, kNoVertex);
+    }
+
+    bool m_terminate;
+    int m_time;
+    std::vector<VertexId> m_parents;
+    std::vector<VisitedState> m_discovered;
+    std::vector<std::pair<int, int>> m_timeclock;
+};
+
+/// \struct TraversalVisitor
+/// \brief  No-op traversal hooks. Visitors passed to the templated searches derive from it and
+///         hide only the hooks they need; calls resolve at compile time and inline, so the hooks
+///         left out cost nothing. To stop a depth-first search early, a visitor sets the
+///         termination flag on the search context it was started with.
+template<typename DataT>
+struct TraversalVisitor {
+    ///
+    void Edge(const DataT&, const DataT&) {}
+
+    ///
+    void VertexEarly(const DataT&) {}
+
+    ///
+    void VertexLate(const DataT&) {}
+};
+
+/// \struct FunctionVisitor
+/// \brief  Adapts three callables, typically lambdas, to the visitor interface
+template<typename EarlyFn, typename EdgeFn, typename LateFn>
+struct FunctionVisitor {
+    ///
+    template<typename DataT>
+    void Edge(const DataT& v1, const DataT& v2) {
+        edge(v1, v2);
+    }
+
+    ///
+    template<typename DataT>
+    void VertexEarly(const DataT& vertex) {
+        vertex_early(vertex);
+    }
+
+    ///
+    template<typename DataT>
+    void VertexLate(const DataT& vertex) {
+        vertex_late(vertex);
+    }
+
+    EarlyFn vertex_early;
+    EdgeFn edge;
+    LateFn vertex_late;
+};
+
+/// fn      MakeVisitor
+template<typename EarlyFn, typename EdgeFn, typename LateFn>
+FunctionVisitor<EarlyFn, EdgeFn, LateFn> MakeVisitor(
+        EarlyFn vertex_early, EdgeFn edge, LateFn vertex_late) {
+    return FunctionVisitor<EarlyFn, EdgeFn, LateFn>{vertex_early, edge, vertex_late};
+}
+
 /// fn      ProcessVertexEarly
 template<typename DataT>
 void ProcessVertexEarly(Graphis<DataT>& graph, DataT vertex) {}
@@ -90,15 +582,21 @@ template<typename DataT>
 void ProcessEdge(Graphis<DataT>& graph, DataT v1, DataT v2) {}
 
 /// class   Graphis
+/// \brief  Vertices are interned as dense VertexIds when first added; edges and all traversal
+///         state are stored in flat vectors indexed by id, and keys are restored only in results
 template<typename DataT>
 class Graphis {
+    friend class DynamicShortestPath<DataT>;
+    friend class GraphisCSR<DataT>;
+
 public:
     ///
     Graphis(bool is_directed = false)
             : m_num_vertices(0)
             , m_num_edges(0)
             , m_is_directed(is_directed)
-            , m_terminate(false)
+            , m_num_tombstones(0)
+            , m_compaction_threshold(kCompactionThreshold)
             , m_vertex_early(ProcessVertexEarly)
             , m_vertex_late(ProcessVertexLate)
             , m_edge_proc(ProcessEdge) {}
@@ -108,43 +606,272 @@ public:
             : m_num_vertices(num_vertices)
             , m_num_edges(0)
             , m_is_directed(is_directed)
-            , m_terminate(false)
+            , m_num_tombstones(0)
+            , m_compaction_threshold(kCompactionThreshold)
             , m_vertex_early(ProcessVertexEarly)
             , m_vertex_late(ProcessVertexLate)
-            , m_edge_proc(ProcessEdge) {}
+            , m_edge_proc(ProcessEdge) {
+        m_edges.reserve(num_vertices);
+        m_degrees.reserve(num_vertices);
+    }
 
     ///
     void AddEdge(DataT src, DataT dst, int weight = 0) {
+        VertexId src_id = InternVertex(src);
+        VertexId dst_id = InternVertex(dst);
+
         // Add edge from src to dst
-        DoAddEdge(src, dst, weight);
+        DoAddEdge(src_id, dst_id, weight);
 
         // Add edge from dst to src for undirected graph
         if (!m_is_directed) {
-            DoAddEdge(dst, src, weight);
+            DoAddEdge(dst_id, src_id, weight);
+        }
+    }
+
+    ///
+    /// \brief  Same result as calling AddEdge for each WeightedEdge of a random-access range in
+    ///         order, but keys are resolved in parallel, arcs are partitioned by source with a
+    ///         parallel counting sort, and every adjacency list grows once to its exact size
+    template<typename EdgeRange>
+    void AddEdges(const EdgeRange& edges, unsigned num_threads = 0) {
+        auto first = std::begin(edges);
+        const std::size_t num_input = std::distance(first, std::end(edges));
+        if (num_input == 0) {
+            return;
+        }
+
+        WorkerTeam team(num_threads);
+        const std::size_t num_chunks = team.Size();
+        const std::size_t chunk_size = (num_input + num_chunks - 1) / num_chunks;
+
+        std::vector<VertexId> srcs(num_input);
+        std::vector<VertexId> dsts(num_input);
+        ResolveEndpoints(team, first, num_input, srcs, dsts);
+
+        // Stable counting sort of the arcs by source: chunk c counts its arcs per vertex, and
+        // scatters them after every earlier chunk's arcs for the same vertex
+        const std::size_t num_verts = m_vertices.Size();
+        std::vector<std::vector<EdgeOffset>> counts(num_chunks);
+        auto for_each_arc = [&](std::size_t chunk, auto visit) {
+            auto hi = std::min(num_input, (chunk + 1) * chunk_size);
+            for (auto edge = chunk * chunk_size; edge < hi; ++edge) {
+                visit(srcs[edge], dsts[edge], first[edge].weight);
+                if (!m_is_directed) {
+                    visit(dsts[edge], srcs[edge], first[edge].weight);
+                }
+            }
+        };
+
+        team.ForEach(
+                0,
+                num_chunks,
+                [&](unsigned, std::size_t lo, std::size_t hi) {
+                    for (auto chunk = lo; chunk < hi; ++chunk) {
+                        counts[chunk].assign(num_verts, 0);
+                        for_each_arc(chunk, [&](VertexId src, VertexId, int) {
+                            ++counts[chunk][src];
+                        });
+                    }
+                },
+                1);
+
+        std::vector<EdgeOffset> offsets(num_verts + 1, 0);
+        for (std::size_t vert = 0; vert < num_verts; ++vert) {
+            EdgeOffset offset = offsets[vert];
+            for (auto& count : counts) {
+                std::swap(offset, count[vert]);
+                offset += count[vert];
+            }
+
+            offsets[vert + 1] = offset;
+        }
+
+        std::vector<AdjacencyArc> arcs(offsets[num_verts]);
+        team.ForEach(
+                0,
+                num_chunks,
+                [&](unsigned, std::size_t lo, std::size_t hi) {
+                    for (auto chunk = lo; chunk < hi; ++chunk) {
+                        auto& cursor = counts[chunk];
+                        for_each_arc(chunk, [&](VertexId src, VertexId dst, int weight) {
+                            arcs[cursor[src]++] = AdjacencyArc{dst, weight};
+                        });
+                    }
+                },
+                1);
+
+        std::vector<int> became_sources(num_chunks, 0);
+        team.ForEach(0, num_verts, [&](unsigned worker, std::size_t lo, std::size_t hi) {
+            for (auto vert = lo; vert < hi; ++vert) {
+                auto num_new = offsets[vert + 1] - offsets[vert];
+                if (num_new == 0) {
+                    continue;
+                }
+
+                auto& adjlist = m_edges[vert];
+                became_sources[worker] += (m_degrees[vert] == 0) ? 1 : 0;
+                adjlist.reserve(adjlist.size() + num_new);
+                adjlist.insert(adjlist.end(),
+                               arcs.begin() + offsets[vert],
+                               arcs.begin() + offsets[vert + 1]);
+                m_degrees[vert] += static_cast<int>(num_new);
+            }
+        });
+
+        for (auto sources : became_sources) {
+            m_num_vertices += sources;
         }
+
+        m_num_edges += static_cast<int>(arcs.size());
+    }
+
+    ///
+    /// \brief  A* search from src to dst. heuristic(vertex) must return a consistent lower bound
+    ///         on the distance from vertex to dst; with a zero heuristic this is ShortestPath.
+    template<typename HeuristicFn>
+    PathResult<DataT> AStarShortestPath(DataT src, DataT dst, HeuristicFn heuristic) const {
+        return DoPointSearch(src, dst, heuristic);
+    }
+
+    ///
+    /// \brief  Meets in the middle of forward and backward Dijkstra searches; directed graphs
+    ///         have no reverse adjacency, so they fall back to ShortestPath
+    PathResult<DataT> BidirectionalShortestPath(DataT src, DataT dst) const {
+        if (m_is_directed) {
+            return ShortestPath(src, dst);
+        }
+
+        PathResult<DataT> result;
+        VertexId source = m_vertices.Find(src);
+        VertexId target = m_vertices.Find(dst);
+        if ((source == kNoVertex) || (target == kNoVertex)) {
+            return result;
+        }
+
+        SearchSide forward(m_vertices.Size(), source);
+        SearchSide backward(m_vertices.Size(), target);
+        VertexId meet = (source == target) ? source : kNoVertex;
+        int best = (source == target) ? 0 : kUnreachable;
+
+        while (!forward.kew.IsEmpty() && !backward.kew.IsEmpty()) {
+            int forward_min = forward.kew.GetKey(forward.kew.Top());
+            int backward_min = backward.kew.GetKey(backward.kew.Top());
+            if ((best != kUnreachable) && (forward_min + backward_min >= best)) {
+                break;
+            }
+
+            bool go_forward = forward_min <= backward_min;
+            SearchSide& side = go_forward ? forward : backward;
+            const SearchSide& other = go_forward ? backward : forward;
+
+            VertexId current = side.kew.PopMin();
+            side.settled[current] = true;
+            ++result.settled;
+            for (const auto& arc : GetArcs(current)) {
+                VertexId candidate = arc.dest;
+                if (side.settled[candidate]) {
+                    continue;
+                }
+
+                int distance = side.distances[current] + arc.weight;
+                if (side.distances[candidate] > distance) {
+                    side.distances[candidate] = distance;
+                    side.parents[candidate] = current;
+                    side.kew.Push(candidate, distance);
+                }
+
+                if ((other.distances[candidate] != kUnreachable)
+                    && (distance + other.distances[candidate] < best)) {
+                    best = distance + other.distances[candidate];
+                    meet = candidate;
+                }
+            }
+        }
+
+        if (meet != kNoVertex) {
+            result.distance = best;
+            for (VertexId vert = meet; vert != kNoVertex; vert = forward.parents[vert]) {
+                result.path.push_back(m_vertices.GetKey(vert));
+            }
+
+            std::reverse(result.path.begin(), result.path.end());
+            for (VertexId vert = backward.parents[meet]; vert != kNoVertex;
+                 vert = backward.parents[vert]) {
+                result.path.push_back(m_vertices.GetKey(vert));
+            }
+        }
+
+        return result;
     }
 
     ///
     /// \see    http://www.geeksforgeeks.org/breadth-first-traversal-for-a-graph/ or
     /// http://www.algorist.com/
     std::vector<DataT> BreadthFirstSearch(DataT root) {
-        InitSearch();
-        return DoBreadthFirstSearch(root);
+        m_search.Reset(m_vertices.Size());
+        StoredHooks visitor{*this};
+        return DoBreadthFirstSearch(m_vertices.Find(root), m_search, visitor);
+    }
+
+    ///
+    /// \brief  Thread-safe form: state goes to search and the stored hooks are not called
+    std::vector<DataT> BreadthFirstSearch(DataT root, SearchContext<DataT>& search) const {
+        return BreadthFirstSearch(root, search, TraversalVisitor<DataT>());
     }
 
     ///
+    /// \brief  Calls visitor's hooks in place of the stored function pointers
+    template<typename VisitorT>
+    std::vector<DataT> BreadthFirstSearch(
+            DataT root, SearchContext<DataT>& search, VisitorT&& visitor) const {
+        search.Reset(m_vertices.Size());
+        return DoBreadthFirstSearch(m_vertices.Find(root), search, visitor);
+    }
+
+    ///
+    /// \brief  Purges every tombstoned arc and renumbers the vertices to close the gaps left by
+    ///         RemoveVertex, keeping their relative order. Ids change, so search contexts and
+    ///         DynamicShortestPath trees built before the call must be rebuilt.
+    void Compact() {
+        PurgeTombstones();
+
+        std::vector<VertexId> renumbered = m_vertices.Compact();
+        std::size_t next = 0;
+        for (VertexId vert = 0; vert < renumbered.size(); ++vert) {
+            if (renumbered[vert] == kNoVertex) {
+                continue;
+            }
+
+            for (auto& arc : m_edges[vert]) {
+                arc.dest = renumbered[arc.dest];
+            }
+
+            m_edges[next].swap(m_edges[vert]);
+            m_degrees[next++] = m_degrees[vert];
+        }
+
+        m_edges.resize(next);
+        m_degrees.resize(next);
+        m_search = SearchContext<DataT>();
+    }
+
+    ///
+    /// \brief  The search state is reset once, so every vertex is visited exactly once no matter
+    ///         how many components there are
     ComponentList<DataT> ConnectedComponents() {
-        InitSearch();
+        m_search.Reset(m_vertices.Size());
+        StoredHooks visitor{*this};
 
         auto component_num = 0;
         ComponentList<DataT> components;
 
-        std::vector<DataT> vertices = GetVertexList();
+        std::vector<VertexId> vertices = m_vertices.GetOrderedIds();
         for (auto vert : vertices) {
-            if (m_discovered.at(vert) == VS_UNDISCOVERD) {
+            if (m_search.m_discovered.at(vert) == VisitedState::VS_UNDISCOVERD) {
                 ++component_num;
-                std::vector<DataT> bfs = BreadthFirstSearch(vert);
-                components.insert(std::make_pair(component_num, bfs));
+                std::vector<DataT> component = DoBreadthFirstSearch(vert, m_search, visitor);
+                components.insert(std::make_pair(component_num, component));
             }
         }
 
@@ -152,142 +879,261 @@ public:
     }
 
     ///
-    std::vector<DataT> DepthFirstSearch(DataT root, bool init = true) {
-        int time = 0;
+    /// \brief  Parallel single-source distances, in GetVertexList order, with the shortest path
+    ///         tree left for FindPath; weights must be non-negative
+    std::vector<int> DeltaSteppingShortestPath(
+            DataT root, int delta = 0, unsigned num_threads = 0) {
+        return DeltaSteppingShortestPath(root, m_search, delta, num_threads);
+    }
+
+    ///
+    /// \brief  Distances from root to every vertex in GetVertexList order, kUnreachable if there
+    ///         is no path, over num_threads workers (0 = all cores). Vertices are binned by
+    ///         distance in buckets delta wide (0 picks max weight / average degree); each bucket
+    ///         relaxes its light edges in parallel rounds until it stays empty, then its heavy
+    ///         edges once. Parents go to search for FindPath; among equally short paths the one
+    ///         recorded depends on timing. Weights must be non-negative.
+    /// \see    Meyer and Sanders, "Delta-stepping: a parallelizable shortest path algorithm",
+    ///         J. Algorithms 49(1), 2003
+    std::vector<int> DeltaSteppingShortestPath(
+            DataT root,
+            SearchContext<DataT>& search,
+            int delta = 0,
+            unsigned num_threads = 0) const {
+        const std::size_t num_verts = m_vertices.Size();
+        if (delta <= 0) {
+            int max_weight = 1;
+            for (VertexId vert = 0; vert < num_verts; ++vert) {
+                for (const auto& arc : GetArcs(vert)) {
+                    max_weight = std::max(max_weight, arc.weight);
+                }
+            }
+
+            // Widened so heavy weights on sparse graphs cannot overflow the product
+            std::int64_t spread =
+                    std::int64_t{max_weight} * m_num_vertices / std::max(1, m_num_edges);
+            delta = static_cast<int>(std::min<std::int64_t>(
+                    std::max<std::int64_t>(1, spread), std::numeric_limits<int>::max()));
+        }
+
+        VertexId source = m_vertices.Find(root);
+        if (source == kNoVertex) {
+            throw std::invalid_argument("DeltaSteppingShortestPath root is not in the graph");
+        }
+
+        WorkerTeam team(num_threads);
+        std::vector<std::atomic<std::uint64_t>> best(num_verts);
+        DoDeltaStepping(source, delta, team, best);
+
+        search.ResetParents(num_verts);
+        for (VertexId vert = 0; vert < num_verts; ++vert) {
+            search.m_parents[vert] =
+                    static_cast<VertexId>(best[vert].load(std::memory_order_relaxed));
+        }
+
+        std::vector<int> distances;
+        distances.reserve(num_verts);
+        for (auto vert : m_vertices.GetOrderedIds()) {
+            std::uint64_t packed = best[vert].load(std::memory_order_relaxed);
+            distances.push_back(
+                    (packed == kUnsettled) ? kUnreachable : static_cast<int>(packed >> 32));
+        }
+
+        return distances;
+    }
 
+    ///
+    /// \brief  With init == false the search continues the current forest: visited state and
+    ///         the entry/exit clock carry over from earlier searches
+    std::vector<DataT> DepthFirstSearch(DataT root, bool init = true) {
         if (init) {
-            InitSearch();
+            m_search.Reset(m_vertices.Size());
         }
 
         std::vector<DataT> dfs;
-        DoDepthFirstSearch(root, dfs, time);
+        StoredHooks visitor{*this};
+        DoDepthFirstSearch(m_vertices.Find(root), m_search, visitor, dfs, [](VertexId) {});
 
         return dfs;
     }
 
     ///
-    std::vector<DataT> DjikstaShortestPath(DataT root) {
-        m_parents.clear();
-        std::vector<AdjacencyNode<DataT>> nodes = GetNodeList();
-        WeightList<DataT> distances;
-        for (auto node : nodes) {
-            distances.insert(std::make_pair(node.dest, std::numeric_limits<int>::max()));
+    /// \brief  Thread-safe form: state goes to search and the stored hooks are not called
+    std::vector<DataT> DepthFirstSearch(
+            DataT root, SearchContext<DataT>& search, bool init = true) const {
+        return DepthFirstSearch(root, search, TraversalVisitor<DataT>(), init);
+    }
+
+    ///
+    /// \brief  Calls visitor's hooks in place of the stored function pointers
+    template<typename VisitorT>
+    std::vector<DataT> DepthFirstSearch(
+            DataT root, SearchContext<DataT>& search, VisitorT&& visitor, bool init = true) const {
+        if (init) {
+            search.Reset(m_vertices.Size());
         }
 
-        distances.at(root) = 0;
+        std::vector<DataT> dfs;
+        DoDepthFirstSearch(m_vertices.Find(root), search, visitor, dfs, [](VertexId) {});
 
-        std::vector<DataT> in_span;
-        auto current = root;
-        while (std::find(in_span.begin(), in_span.end(), current) == in_span.end()) {
-            in_span.push_back(current);
-            AdjacencyList<DataT> adjlist = GetAdjacencyList(current);
-            for (auto adj : adjlist) {
-                auto candidate = adj.dest;
-                auto weight = adj.weight;
+        return dfs;
+    }
 
-                auto inc = std::find(in_span.begin(), in_span.end(), candidate);
-                if ((distances.at(candidate) > distances.at(current) + weight)
-                    && (inc == in_span.end())) {
-                    distances.at(candidate) = distances.at(current) + weight;
-                    m_parents.insert(std::make_pair(candidate, current));
-                }
-            }
+    ///
+    /// \brief  Returns vertices in the order they are settled; ties settle in insertion order
+    std::vector<DataT> DjikstaShortestPath(
+            DataT root, QueueKind queue = QueueKind::QK_BINARY_HEAP) {
+        return DjikstaShortestPath(root, m_search, queue);
+    }
 
-            auto mindist = std::numeric_limits<int>::max();
-            for (auto node : nodes) {
-                auto inc = std::find(in_span.begin(), in_span.end(), node.dest);
-                if ((inc == in_span.end()) && (mindist > distances.at(node.dest))) {
-                    mindist = distances.at(node.dest);
-                    current = node.dest;
-                }
-            }
+    ///
+    /// \brief  Thread-safe form: parents go to search
+    std::vector<DataT> DjikstaShortestPath(
+            DataT root,
+            SearchContext<DataT>& search,
+            QueueKind queue = QueueKind::QK_BINARY_HEAP) const {
+        if (queue == QueueKind::QK_RADIX_HEAP) {
+            return DoRadixShortestPath(root, search);
         }
 
-        return in_span;
+        return DoSpanningSearch(root, search, [](int distance, int weight) {
+            return distance + weight;
+        });
     }
 
     ///
-    void FindPath(DataT start, DataT end, std::stack<DataT>& path) {
-        auto pend = m_parents.find(end);
-        if ((start == end) || (pend == m_parents.end())) {
-            path.push(start);
-        } else {
-            path.push(end);
-            FindPath(start, m_parents.at(end), path);
+    void FindPath(DataT start, DataT end, std::stack<DataT>& path) const {
+        FindPath(start, end, path, m_search);
+    }
+
+    ///
+    void FindPath(
+            DataT start,
+            DataT end,
+            std::stack<DataT>& path,
+            const SearchContext<DataT>& search) const {
+        const auto& parents = search.m_parents;
+        VertexId first = m_vertices.Find(start);
+        VertexId current = m_vertices.Find(end);
+        while ((current != first) && (current < parents.size())
+               && (parents[current] != kNoVertex)) {
+            path.push(m_vertices.GetKey(current));
+            current = parents[current];
         }
+
+        path.push(start);
     }
 
+    ///
+    /// \brief  Snapshots the graph into an immutable CSR layout; defined in GraphisCSR.hpp
+    GraphisCSR<DataT> Freeze() const;
+
     ///
     AdjacencyList<DataT> GetAdjacencyList(DataT vertex) const {
-        auto edgeit = m_edges.find(vertex);
-        if (edgeit != m_edges.end()) {
-            return m_edges.at(vertex);
-        } else {
-            return AdjacencyList<DataT>();
+        AdjacencyList<DataT> adjlist;
+
+        VertexId id = m_vertices.Find(vertex);
+        if (id != kNoVertex) {
+            for (const auto& arc : GetArcs(id)) {
+                adjlist.emplace_back(m_vertices.GetKey(arc.dest), arc.weight);
+            }
         }
+
+        return adjlist;
     }
 
     ///
     std::vector<DataT> GetAdjacentVertices(DataT vertex) const {
-        auto edgeit = m_edges.find(vertex);
-        if (edgeit != m_edges.end()) {
-            std::vector<DataT> adjacencies;
+        std::vector<DataT> adjacencies;
 
-            AdjacencyList<DataT> adjlist = m_edges.at(vertex);
-            for (auto adj : adjlist) {
-                adjacencies.push_back(adj.dest);
+        VertexId id = m_vertices.Find(vertex);
+        if (id != kNoVertex) {
+            adjacencies.reserve(m_degrees[id]);
+            for (const auto& arc : GetArcs(id)) {
+                adjacencies.push_back(m_vertices.GetKey(arc.dest));
             }
-
-            return adjacencies;
-        } else {
-            return std::vector<DataT>();
         }
+
+        return adjacencies;
     }
 
     ///
-    EdgeClassification GetEdgeClassification(DataT v1, DataT v2) {
-        auto pend = m_parents.find(v2);
-        if (pend != m_parents.end()) {
-            if (m_parents.at(v2) != v1) {
-                return EC_TREE;
-            }
+    /// \brief  Classifies v1->v2 against the current depth-first search; meant to be called from
+    ///         the edge hook while the search is running
+    /// \see    Skiena, The Algorithm Design Manual, 5.9.1
+    EdgeClassification GetEdgeClassification(DataT v1, DataT v2) const {
+        return GetEdgeClassification(v1, v2, m_search);
+    }
+
+    ///
+    EdgeClassification GetEdgeClassification(
+            DataT v1, DataT v2, const SearchContext<DataT>& search) const {
+        VertexId id1 = m_vertices.Find(v1);
+        VertexId id2 = m_vertices.Find(v2);
+
+        if (search.m_parents.at(id2) == id1) {
+            return EdgeClassification::EC_TREE;
         }
 
-        auto visited = m_discovered.at(v2);
-        if ((visited == VS_DISCOVERED) && (visited != VS_PROCESSED)) {
-            return EC_BACK_EDGE;
+        auto visited = search.m_discovered.at(id2);
+        if (visited == VisitedState::VS_DISCOVERED) {
+            return EdgeClassification::EC_BACK_EDGE;
         }
 
-        auto tyme1 = m_timeclock.find(v1);
-        auto tyme2 = m_timeclock.find(v2);
-        if ((tyme1 != m_timeclock.end()) && (tyme2 != m_timeclock.end())) {
-            if (visited == VS_PROCESSED) {
-                auto t1 = tyme1->second;
-                auto t2 = tyme2->second;
+        if (visited == VisitedState::VS_PROCESSED) {
+            auto t1 = search.m_timeclock.at(id1).first;
+            auto t2 = search.m_timeclock[id2].first;
+            if (t2 > t1) {
+                return EdgeClassification::EC_FORWARD_EDGE;
+            }
 
-                if (t2.first > t1.first) {
-                    return EC_FORWARD_EDGE;
-                }
+            if (t2 < t1) {
+                return EdgeClassification::EC_CROSS_EDGE;
+            }
+        }
 
-                if (t2.first < t1.first) {
-                    return EC_CROSS_EDGE;
-                }
+        return EdgeClassification::EC_UNCLASSIFIED;
+    }
+
+    ///
+    /// \brief  Discovery and finishing times of the last depth-first search
+    EntryList<DataT> GetEntryTimes() const {
+        return GetEntryTimes(m_search);
+    }
+
+    ///
+    EntryList<DataT> GetEntryTimes(const SearchContext<DataT>& search) const {
+        const auto& timeclock = search.m_timeclock;
+        EntryList<DataT> times;
+        for (VertexId vert = 0; vert < timeclock.size(); ++vert) {
+            if (timeclock[vert].first != 0) {
+                times.insert(std::make_pair(m_vertices.GetKey(vert), timeclock[vert]));
             }
         }
 
-        return EC_UNCLASSIFIED;
+        return times;
+    }
+
+    ///
+    /// \brief  Visits the same (vertex, weight) pairs as GetAdjacencyList without copying them;
+    ///         an unknown vertex yields an empty range
+    NeighborRange<DataT> GetNeighbors(const DataT& vertex) const {
+        VertexId id = m_vertices.Find(vertex);
+        return NeighborRange<DataT>(
+                id != kNoVertex ? GetArcs(id) : ArcRange(nullptr, nullptr), &m_vertices);
     }
 
     ///
     std::vector<AdjacencyNode<DataT>> GetNodeList() const {
-        std::set<AdjacencyNode<DataT>> nodes;
-        for (auto edge : m_edges) {
-            for (auto node : edge.second) {
-                nodes.insert(node.dest);
+        std::vector<AdjacencyNode<DataT>> nodes;
+        std::vector<bool> is_dest = GetDestinations();
+        for (auto vert : m_vertices.GetOrderedIds()) {
+            if (is_dest[vert]) {
+                nodes.push_back(AdjacencyNode<DataT>(m_vertices.GetKey(vert)));
             }
         }
 
-        return std::vector<AdjacencyNode<DataT>>(nodes.begin(), nodes.end());
+        return nodes;
     }
 
     ///
@@ -295,6 +1141,12 @@ public:
         return m_num_edges;
     }
 
+    ///
+    /// \brief  Removed arcs still occupying adjacency storage
+    std::size_t GetNumTombstones() const {
+        return m_num_tombstones;
+    }
+
     ///
     int GetNumVerts() const {
         return m_num_vertices;
@@ -302,20 +1154,32 @@ public:
 
     ///
     ParentList<DataT> GetParents() const {
-        return m_parents;
+        return GetParents(m_search);
     }
 
     ///
-    std::vector<DataT> GetVertexList() const {
-        std::set<DataT> verts;
-        for (auto edge : m_edges) {
-            verts.insert(edge.first);
-            for (auto node : edge.second) {
-                verts.insert(node.dest);
+    ParentList<DataT> GetParents(const SearchContext<DataT>& search) const {
+        const auto& parent = search.m_parents;
+        ParentList<DataT> parents;
+        for (VertexId vert = 0; vert < parent.size(); ++vert) {
+            if (parent[vert] != kNoVertex) {
+                parents.insert(
+                        std::make_pair(m_vertices.GetKey(vert), m_vertices.GetKey(parent[vert])));
             }
         }
 
-        return std::vector<DataT>(verts.begin(), verts.end());
+        return parents;
+    }
+
+    ///
+    std::vector<DataT> GetVertexList() const {
+        std::vector<DataT> verts;
+        verts.reserve(m_vertices.Size());
+        for (auto vert : m_vertices.GetOrderedIds()) {
+            verts.push_back(m_vertices.GetKey(vert));
+        }
+
+        return verts;
     }
 
     ///
@@ -330,42 +1194,9 @@ public:
 
     ///
     std::vector<DataT> PrimSpanningTree(DataT root) {
-        m_parents.clear();
-        std::vector<AdjacencyNode<DataT>> nodes = GetNodeList();
-        WeightList<DataT> distances;
-        for (auto node : nodes) {
-            distances.insert(std::make_pair(node.dest, std::numeric_limits<int>::max()));
-        }
-
-        distances.at(root) = 0;
-
-        std::vector<DataT> in_span;
-        auto current = root;
-        while (std::find(in_span.begin(), in_span.end(), current) == in_span.end()) {
-            in_span.push_back(current);
-            AdjacencyList<DataT> adjlist = GetAdjacencyList(current);
-            for (auto adj : adjlist) {
-                auto candidate = adj.dest;
-                auto weight = adj.weight;
-
-                auto inc = std::find(in_span.begin(), in_span.end(), candidate);
-                if ((distances.at(candidate) > weight) && (inc == in_span.end())) {
-                    distances.at(candidate) = weight;
-                    m_parents.insert(std::make_pair(candidate, current));
-                }
-            }
-
-            auto mindist = std::numeric_limits<int>::max();
-            for (auto node : nodes) {
-                auto inc = std::find(in_span.begin(), in_span.end(), node.dest);
-                if ((inc == in_span.end()) && (mindist > distances.at(node.dest))) {
-                    mindist = distances.at(node.dest);
-                    current = node.dest;
-                }
-            }
-        }
-
-        return in_span;
+        return DoSpanningSearch(root, m_search, [](int, int weight) {
+            return weight;
+        });
     }
 
     ///
@@ -374,31 +1205,70 @@ public:
         std::cout << "Vertices: " << m_num_vertices << std::endl;
         std::cout << "Edges   : " << m_num_edges << std::endl;
 
-        std::vector<DataT> verts = GetVertexList();
-        for (auto vert : verts) {
-            std::cout << std::setw(8) << vert << ": ";
-            std::vector<DataT> adjlist = GetAdjacentVertices(vert);
-            for (auto adj : adjlist) {
-                std::cout << adj << " ";
+        for (auto vert : m_vertices.GetOrderedIds()) {
+            std::cout << std::setw(8) << m_vertices.GetKey(vert) << ": ";
+            for (const auto& arc : GetArcs(vert)) {
+                std::cout << m_vertices.GetKey(arc.dest) << " ";
             }
 
             std::cout << std::endl;
+            std::cout << "Degree  : " << m_degrees[vert] << std::endl;
+        }
+    }
 
-            auto degrees = 0;
-            auto adegree = m_degrees.find(vert);
-            if (adegree != m_degrees.end()) {
-                degrees = m_degrees.at(vert);
-            } else {
-                degrees = 0;
-            }
+    ///
+    /// \brief  Removes every src->dst edge, and the dst->src arcs too if undirected; returns
+    ///         false if there was none
+    bool RemoveEdge(DataT src, DataT dst) {
+        VertexId src_id = m_vertices.Find(src);
+        VertexId dst_id = m_vertices.Find(dst);
+        if ((src_id == kNoVertex) || (dst_id == kNoVertex)) {
+            return false;
+        }
 
-            std::cout << "Degree  : " << degrees << std::endl;
+        bool removed = DoRemoveEdge(src_id, dst_id);
+        if (!m_is_directed) {
+            DoRemoveEdge(dst_id, src_id);
         }
+
+        PurgeIfNeeded();
+        return removed;
     }
 
     ///
-    void PushSorted(DataT vertex) {
-        m_sorted.push(vertex);
+    /// \brief  Removes vertex and every edge into or out of it; returns false if it was not in
+    ///         the graph. Its id is retired, not reused, until Compact. Undirected graphs find
+    ///         the incoming arcs through the vertex's own; directed graphs scan every list.
+    bool RemoveVertex(DataT vertex) {
+        VertexId id = m_vertices.Find(vertex);
+        if (id == kNoVertex) {
+            return false;
+        }
+
+        if (m_is_directed) {
+            for (VertexId src = 0; src < m_edges.size(); ++src) {
+                DoRemoveEdge(src, id);
+            }
+        } else {
+            for (const auto& arc : m_edges[id]) {
+                if (arc.dest != kNoVertex) {
+                    DoRemoveEdge(arc.dest, id);
+                }
+            }
+        }
+
+        DoRemoveEdge(id, kNoVertex);
+        m_vertices.Remove(vertex);
+        PurgeIfNeeded();
+        return true;
+    }
+
+    ///
+    /// \brief  Tombstoned arcs are purged once they make up more than this fraction of the
+    ///         stored arcs; purging keeps vertex ids. 1.0 or more leaves it all to Compact.
+    void SetCompactionThreshold(double threshold) {
+        m_compaction_threshold = threshold;
+        PurgeIfNeeded();
     }
 
     ///
@@ -406,6 +1276,34 @@ public:
         m_is_directed = is_directed;
     }
 
+    ///
+    /// \brief  Gives every src->dst edge (both directions if undirected) the new weight
+    void SetEdgeWeight(DataT src, DataT dst, int weight) {
+        VertexId src_id = m_vertices.Find(src);
+        VertexId dst_id = m_vertices.Find(dst);
+        auto reweigh = [&](VertexId from, VertexId to) {
+            bool found = false;
+            if ((from != kNoVertex) && (to != kNoVertex)) {
+                for (auto& arc : m_edges[from]) {
+                    if (arc.dest == to) {
+                        arc.weight = weight;
+                        found = true;
+                    }
+                }
+            }
+
+            return found;
+        };
+
+        if (!reweigh(src_id, dst_id)) {
+            throw std::invalid_argument("SetEdgeWeight needs an existing edge");
+        }
+
+        if (!m_is_directed) {
+            reweigh(dst_id, src_id);
+        }
+    }
+
     ///
     void SetProcessEdgeFn(ProcEdgeFn<DataT> func) {
         m_edge_proc = func;
@@ -423,152 +1321,587 @@ public:
 
     ///
     void SetTerminationFlag(bool terminate) {
-        m_terminate = terminate;
+        m_search.SetTerminationFlag(terminate);
     }
 
     ///
+    /// \brief  Point-to-point Dijkstra that stops as soon as dst is settled; leaves the parents
+    ///         used by FindPath untouched
+    PathResult<DataT> ShortestPath(DataT src, DataT dst) const {
+        return DoPointSearch(src, dst, [](const DataT&) {
+            return 0;
+        });
+    }
+
+    ///
+    /// \brief  Reverse finishing order of a depth-first forest rooted in key order. The hooks
+    ///         still fire, e.g. to classify edges, but the order no longer depends on them.
     std::vector<DataT> TopologicalSort() {
-        InitSearch();
-        ClearSorted();
+        m_search.Reset(m_vertices.Size());
+        StoredHooks visitor{*this};
+
+        std::vector<VertexId> finished;
+        finished.reserve(m_vertices.Size());
 
         std::vector<DataT> dfs;
-        std::vector<DataT> vertices = GetVertexList();
+        std::vector<VertexId> vertices = m_vertices.GetOrderedIds();
         for (auto vertex : vertices) {
-            if (m_discovered.at(vertex) == VS_UNDISCOVERD) {
-                dfs = DepthFirstSearch(vertex, false);
+            if (m_search.m_discovered.at(vertex) == VisitedState::VS_UNDISCOVERD) {
+                DoDepthFirstSearch(vertex, m_search, visitor, dfs, [&](VertexId done) {
+                    finished.push_back(done);
+                });
             }
         }
 
         std::vector<DataT> sorted;
-        while (!m_sorted.empty()) {
-            sorted.push_back(m_sorted.top());
-            m_sorted.pop();
+        sorted.reserve(finished.size());
+        for (auto vert = finished.rbegin(); vert != finished.rend(); ++vert) {
+            sorted.push_back(m_vertices.GetKey(*vert));
         }
 
         return sorted;
     }
 
 private:
-    ///
-    void ClearSorted() {
-        while (!m_sorted.empty()) {
-            m_sorted.pop();
+    /// Default SetCompactionThreshold
+    static constexpr double kCompactionThreshold = 0.25;
+
+    /// Delta-stepping packs a tentative distance and its parent into one atomic word
+    static constexpr std::uint64_t kUnsettled = std::numeric_limits<std::uint64_t>::max();
+
+    /// \struct SearchSide
+    /// \brief  Per-query heap and visit state of one Dijkstra or A* frontier
+    struct SearchSide {
+        ///
+        SearchSide(std::size_t num_vertices, VertexId root)
+                : distances(num_vertices, kUnreachable)
+                , parents(num_vertices, kNoVertex)
+                , settled(num_vertices, false)
+                , kew(num_vertices) {
+            distances[root] = 0;
+            kew.Push(root, 0);
+        }
+
+        std::vector<int> distances;
+        std::vector<VertexId> parents;
+        std::vector<bool> settled;
+        IndexedHeap<int> kew;
+    };
+
+    /// \struct StoredHooks
+    /// \brief  Visitor that forwards to the function pointers installed with SetProcess*
+    struct StoredHooks {
+        void Edge(const DataT& v1, const DataT& v2) {
+            graph.m_edge_proc(graph, v1, v2);
         }
-    }
+
+        void VertexEarly(const DataT& vertex) {
+            graph.m_vertex_early(graph, vertex);
+        }
+
+        void VertexLate(const DataT& vertex) {
+            graph.m_vertex_late(graph, vertex);
+        }
+
+        Graphis& graph;
+    };
 
     ///
     /// \brief  Adds an edge from src to dst; src is the key, all edges from it reside in its edge
     /// list
-    void DoAddEdge(DataT src, DataT dst, int weight = 0) {
+    void DoAddEdge(VertexId src, VertexId dst, int weight = 0) {
         // Add edge from src to dst
-        AdjacencyNode<DataT> dstnode(dst, weight);
-
-        auto anedge = m_edges.find(src);
-        if (anedge == m_edges.end()) {
+        if (m_degrees[src] == 0) {
             ++m_num_vertices;
-            AdjacencyList<DataT> nulist;
-            m_edges.insert(std::make_pair(src, nulist));
-        }
-
-        auto adegree = m_degrees.find(src);
-        if (adegree == m_degrees.end()) {
-            int num_degrees = 0;
-            m_degrees.insert(std::make_pair(src, num_degrees));
         }
 
         ++m_degrees[src];
-        m_edges[src].push_front(dstnode);
+        m_edges[src].push_back(AdjacencyArc{dst, weight});
         ++m_num_edges;
     }
 
     ///
-    std::vector<DataT> DoBreadthFirstSearch(DataT root) {
-        std::queue<DataT> kew;
-        m_discovered.at(root) = VS_DISCOVERED;
+    /// \brief  Tombstones the src->dst arcs in place, undoing DoAddEdge's bookkeeping for each;
+    ///         dst == kNoVertex tombstones all of src's arcs
+    bool DoRemoveEdge(VertexId src, VertexId dst) {
+        if (m_degrees[src] == 0) {
+            return false;
+        }
+
+        int num_removed = 0;
+        for (auto& arc : m_edges[src]) {
+            if ((arc.dest != kNoVertex) && ((arc.dest == dst) || (dst == kNoVertex))) {
+                arc.dest = kNoVertex;
+                ++num_removed;
+            }
+        }
+
+        m_degrees[src] -= num_removed;
+        m_num_edges -= num_removed;
+        m_num_tombstones += num_removed;
+        if ((num_removed != 0) && (m_degrees[src] == 0)) {
+            --m_num_vertices;
+        }
+
+        return num_removed != 0;
+    }
+
+    ///
+    /// \brief  Shared A*/Dijkstra loop; queue keys are distance plus heuristic estimate
+    template<typename HeuristicFn>
+    PathResult<DataT> DoPointSearch(DataT src, DataT dst, HeuristicFn heuristic) const {
+        PathResult<DataT> result;
+        VertexId source = m_vertices.Find(src);
+        VertexId target = m_vertices.Find(dst);
+        if ((source == kNoVertex) || (target == kNoVertex)) {
+            return result;
+        }
+
+        SearchSide search(m_vertices.Size(), source);
+        while (!search.kew.IsEmpty()) {
+            VertexId current = search.kew.PopMin();
+            search.settled[current] = true;
+            ++result.settled;
+            if (current == target) {
+                break;
+            }
+
+            for (const auto& arc : GetArcs(current)) {
+                VertexId candidate = arc.dest;
+                int distance = search.distances[current] + arc.weight;
+                if (!search.settled[candidate] && (search.distances[candidate] > distance)) {
+                    search.distances[candidate] = distance;
+                    search.parents[candidate] = current;
+                    search.kew.Push(candidate, distance + heuristic(m_vertices.GetKey(candidate)));
+                }
+            }
+        }
+
+        if (search.settled[target]) {
+            result.distance = search.distances[target];
+            for (VertexId vert = target; vert != kNoVertex; vert = search.parents[vert]) {
+                result.path.push_back(m_vertices.GetKey(vert));
+            }
+
+            std::reverse(result.path.begin(), result.path.end());
+        }
+
+        return result;
+    }
+
+    ///
+    template<typename VisitorT>
+    std::vector<DataT> DoBreadthFirstSearch(
+            VertexId root, SearchContext<DataT>& search, VisitorT& visitor) const {
+        auto& discovered = search.m_discovered;
+        std::queue<VertexId> kew;
+        discovered.at(root) = VisitedState::VS_DISCOVERED;
         kew.push(root);
 
         std::vector<DataT> bfs;
         while (!kew.empty()) {
-            DataT current_vertex = kew.front();
-            bfs.push_back(current_vertex);
+            VertexId current_vertex = kew.front();
+            bfs.push_back(m_vertices.GetKey(current_vertex));
             kew.pop();
-            m_discovered.at(current_vertex) = VS_PROCESSED;
-            m_vertex_early(*this, current_vertex);
+            discovered[current_vertex] = VisitedState::VS_PROCESSED;
+            visitor.VertexEarly(m_vertices.GetKey(current_vertex));
 
-            std::vector<DataT> adjlist = GetAdjacentVertices(current_vertex);
-            for (auto vert : adjlist) {
-                if ((m_discovered.at(vert) != VS_PROCESSED) || IsDirected()) {
-                    m_edge_proc(*this, root, vert);
+            for (const auto& arc : GetArcs(current_vertex)) {
+                VertexId vert = arc.dest;
+                if ((discovered[vert] != VisitedState::VS_PROCESSED) || IsDirected()) {
+                    visitor.Edge(m_vertices.GetKey(root), m_vertices.GetKey(vert));
                 }
 
-                if (m_discovered.at(vert) == VS_UNDISCOVERD) {
-                    m_discovered.at(vert) = VS_DISCOVERED;
+                if (discovered[vert] == VisitedState::VS_UNDISCOVERD) {
+                    discovered[vert] = VisitedState::VS_DISCOVERED;
                     kew.push(vert);
-                    m_parents.insert(std::make_pair(vert, current_vertex));
+                    search.m_parents[vert] = current_vertex;
                 }
             }
 
-            m_vertex_late(*this, current_vertex);
+            visitor.VertexLate(m_vertices.GetKey(current_vertex));
         }
 
         return bfs;
     }
 
     ///
-    void DoDepthFirstSearch(DataT root, std::vector<DataT>& dfs, int time) {
-        m_discovered.at(root) = VS_DISCOVERED;
-        dfs.push_back(root);
+    /// \brief  Delta-stepping from root into best[v] = distance << 32 | parent. A relaxation
+    ///         only wins with a strictly shorter distance, and distance and parent change in one
+    ///         compare-and-swap, so they always agree and the parents form a tree. Each worker
+    ///         keeps its own buckets; the next bucket is the smallest non-empty one of any.
+    void DoDeltaStepping(
+            VertexId root,
+            int delta,
+            WorkerTeam& team,
+            std::vector<std::atomic<std::uint64_t>>& best) const {
+        for (auto& packed : best) {
+            packed.store(kUnsettled, std::memory_order_relaxed);
+        }
 
-        int entry_time = ++time;
+        std::vector<std::vector<std::vector<VertexId>>> buckets(team.Size());
+        std::vector<std::vector<VertexId>> settled(team.Size());
+        auto distance_of = [&](VertexId vert) {
+            return static_cast<std::int64_t>(best[vert].load(std::memory_order_relaxed) >> 32);
+        };
+
+        auto relax = [&](unsigned worker, VertexId from, VertexId to, std::int64_t distance) {
+            std::uint64_t offer = (static_cast<std::uint64_t>(distance) << 32) | from;
+            std::uint64_t current = best[to].load(std::memory_order_relaxed);
+            while ((offer >> 32) < (current >> 32)) {
+                if (best[to].compare_exchange_weak(current, offer)) {
+                    auto& mine = buckets[worker];
+                    std::size_t bucket = distance / delta;
+                    if (bucket >= mine.size()) {
+                        mine.resize(bucket + 1);
+                    }
+
+                    mine[bucket].push_back(to);
+                    return;
+                }
+            }
+        };
+
+        // Relaxes the light (light == true) or heavy arcs of the listed vertices in bucket
+        auto expand = [&](const std::vector<VertexId>& vertices, std::size_t bucket, bool light) {
+            team.ForEach(0, vertices.size(), [&](unsigned worker, std::size_t lo, std::size_t hi) {
+                for (auto slot = lo; slot < hi; ++slot) {
+                    VertexId vert = vertices[slot];
+                    std::int64_t distance = distance_of(vert);
+                    if (static_cast<std::size_t>(distance / delta) != bucket) {
+                        continue;
+                    }
+
+                    if (light) {
+                        settled[worker].push_back(vert);
+                    }
+
+                    for (const auto& arc : GetArcs(vert)) {
+                        if ((arc.weight <= delta) == light) {
+                            relax(worker, vert, arc.dest, distance + arc.weight);
+                        }
+                    }
+                }
+            });
+        };
+
+        // Moves every worker's copy of bucket into frontier
+        auto gather = [&](std::size_t bucket, std::vector<VertexId>& frontier) {
+            frontier.clear();
+            for (auto& mine : buckets) {
+                if (bucket < mine.size()) {
+                    frontier.insert(frontier.end(), mine[bucket].begin(), mine[bucket].end());
+                    mine[bucket].clear();
+                }
+            }
+        };
+
+        best[root].store(static_cast<std::uint64_t>(kNoVertex), std::memory_order_relaxed);
+        std::vector<VertexId> frontier(1, root);
+        std::vector<VertexId> heavy;
+        std::size_t bucket = 0;
+        for (;;) {
+            while (!frontier.empty()) {
+                expand(frontier, bucket, true);
+                gather(bucket, frontier);
+            }
+
+            heavy.clear();
+            for (auto& mine : settled) {
+                heavy.insert(heavy.end(), mine.begin(), mine.end());
+                mine.clear();
+            }
 
-        m_vertex_early(*this, root);
-        std::vector<DataT> adjlist = GetAdjacentVertices(root);
-        for (auto vert : adjlist) {
-            if (m_discovered.at(vert) == VS_UNDISCOVERD) {
-                m_parents.insert(std::make_pair(root, vert));
-                m_edge_proc(*this, root, vert);
-                DoDepthFirstSearch(vert, dfs, time);
-            } else if ((m_discovered.at(vert) != VS_PROCESSED) || IsDirected()) {
-                m_edge_proc(*this, root, vert);
+            expand(heavy, bucket, false);
 
-                if (m_terminate) {
-                    return;
+            std::size_t next = std::numeric_limits<std::size_t>::max();
+            for (const auto& mine : buckets) {
+                for (auto candidate = bucket + 1; candidate < std::min(next, mine.size());
+                     ++candidate) {
+                    if (!mine[candidate].empty()) {
+                        next = candidate;
+                        break;
+                    }
                 }
             }
+
+            if (next == std::numeric_limits<std::size_t>::max()) {
+                return;
+            }
+
+            bucket = next;
+            gather(bucket, frontier);
         }
-        m_vertex_late(*this, root);
+    }
 
-        int exit_time = ++time;
+    ///
+    /// \brief  Explicit-stack DFS, so depth is bounded by memory rather than the call stack.
+    ///         Hooks fire in the recursive order: early on discovery, edge before descending,
+    ///         late once every edge is done; on_finish(vertex) follows the late hook. Setting
+    ///         the termination flag from a hook abandons the whole search.
+    template<typename VisitorT, typename FinishFn>
+    void DoDepthFirstSearch(
+            VertexId root,
+            SearchContext<DataT>& search,
+            VisitorT& visitor,
+            std::vector<DataT>& dfs,
+            FinishFn on_finish) const {
+        auto& discovered = search.m_discovered;
+        auto& timeclock = search.m_timeclock;
+
+        // Edges are visited newest first, so each frame counts its cursor down
+        std::vector<std::pair<VertexId, std::size_t>> pending;
+
+        auto discover = [&](VertexId vert) {
+            discovered.at(vert) = VisitedState::VS_DISCOVERED;
+            dfs.push_back(m_vertices.GetKey(vert));
+            timeclock[vert].first = ++search.m_time;
+            visitor.VertexEarly(m_vertices.GetKey(vert));
+            pending.push_back(std::make_pair(vert, m_edges[vert].size()));
+        };
+
+        discover(root);
+        while (!pending.empty() && !search.m_terminate) {
+            VertexId current = pending.back().first;
+            if (pending.back().second == 0) {
+                visitor.VertexLate(m_vertices.GetKey(current));
+                timeclock[current].second = ++search.m_time;
+                discovered[current] = VisitedState::VS_PROCESSED;
+                on_finish(current);
+                pending.pop_back();
+                continue;
+            }
+
+            VertexId vert = m_edges[current][--pending.back().second].dest;
+            if (vert == kNoVertex) {
+                continue;
+            }
 
-        m_timeclock.insert(std::make_pair(root, std::make_pair(entry_time, exit_time)));
-        m_discovered.at(root) = VS_PROCESSED;
+            if (discovered[vert] == VisitedState::VS_UNDISCOVERD) {
+                search.m_parents[vert] = current;
+                visitor.Edge(m_vertices.GetKey(current), m_vertices.GetKey(vert));
+                if (!search.m_terminate) {
+                    discover(vert);
+                }
+            } else if ((discovered[vert] != VisitedState::VS_PROCESSED) || IsDirected()) {
+                visitor.Edge(m_vertices.GetKey(current), m_vertices.GetKey(vert));
+            }
+        }
     }
 
     ///
-    void InitSearch() {
-        m_parents.clear();
-        m_discovered.clear();
-        m_timeclock.clear();
-        std::vector<DataT> vertices = GetVertexList();
-        for (auto vert : vertices) {
-            std::pair<DataT, VisitedState> init(vert, VS_UNDISCOVERD);
-            m_discovered.insert(init);
+    /// \brief  Dijkstra over a radix heap; stale queue entries are skipped when popped
+    std::vector<DataT> DoRadixShortestPath(DataT root, SearchContext<DataT>& search) const {
+        search.ResetParents(m_vertices.Size());
+        std::vector<int> distances(m_vertices.Size(), std::numeric_limits<int>::max());
+        std::vector<bool> in_span(m_vertices.Size(), false);
+        RadixHeap kew;
+
+        auto source = m_vertices.Find(root);
+        distances.at(source) = 0;
+        kew.Push(source, 0);
+
+        std::vector<DataT> span;
+        while (!kew.IsEmpty()) {
+            auto current = kew.PopMin().second;
+            if (in_span[current]) {
+                continue;
+            }
+
+            in_span[current] = true;
+            span.push_back(m_vertices.GetKey(current));
+            for (const auto& arc : GetArcs(current)) {
+                auto candidate = arc.dest;
+                auto distance = distances[current] + arc.weight;
+                if ((distances[candidate] > distance) && !in_span[candidate]) {
+                    distances[candidate] = distance;
+                    search.m_parents[candidate] = current;
+                    kew.Push(candidate, static_cast<std::uint32_t>(distance));
+                }
+            }
+        }
+
+        return span;
+    }
+
+    ///
+    /// \brief  Shared Dijkstra/Prim loop over an indexed heap; relax(distance to current, edge
+    ///         weight) yields the candidate distance of the edge's target
+    template<typename RelaxFn>
+    std::vector<DataT> DoSpanningSearch(
+            DataT root, SearchContext<DataT>& search, RelaxFn relax) const {
+        search.ResetParents(m_vertices.Size());
+        std::vector<bool> in_span(m_vertices.Size(), false);
+        IndexedHeap<int> kew(m_vertices.Size());
+
+        VertexId source = m_vertices.Find(root);
+        if (source == kNoVertex) {
+            throw std::out_of_range("Search root is not in the graph");
+        }
+
+        kew.Push(source, 0);
+
+        std::vector<DataT> span;
+        while (!kew.IsEmpty()) {
+            auto current = kew.PopMin();
+            auto current_distance = kew.GetKey(current);
+            in_span[current] = true;
+            span.push_back(m_vertices.GetKey(current));
+
+            for (const auto& arc : GetArcs(current)) {
+                auto candidate = arc.dest;
+                if (in_span[candidate]) {
+                    continue;
+                }
+
+                auto distance = relax(current_distance, arc.weight);
+                if (!kew.Contains(candidate) || (kew.GetKey(candidate) > distance)) {
+                    kew.Push(candidate, distance);
+                    search.m_parents[candidate] = current;
+                }
+            }
+        }
+
+        return span;
+    }
+
+    ///
+    ArcRange GetArcs(VertexId vertex) const {
+        const auto& arcs = m_edges[vertex];
+        return ArcRange(arcs.data(), arcs.data() + arcs.size(), m_degrees[vertex]);
+    }
+
+    ///
+    /// \brief  Flags every vertex that is the destination of at least one edge
+    std::vector<bool> GetDestinations() const {
+        std::vector<bool> is_dest(m_vertices.Size(), false);
+        for (const auto& adjlist : m_edges) {
+            for (const auto& arc : adjlist) {
+                if (arc.dest != kNoVertex) {
+                    is_dest[arc.dest] = true;
+                }
+            }
+        }
+
+        return is_dest;
+    }
+
+    ///
+    VertexId InternVertex(const DataT& vertex) {
+        VertexId id = m_vertices.Intern(vertex);
+        if (id == m_edges.size()) {
+            m_edges.emplace_back();
+            m_degrees.push_back(0);
+        }
+
+        return id;
+    }
+
+    ///
+    void PurgeIfNeeded() {
+        if (m_num_tombstones > m_compaction_threshold * (m_num_tombstones + m_num_edges)) {
+            PurgeTombstones();
+        }
+    }
+
+    ///
+    /// \brief  Drops tombstoned arcs and releases the memory they held; vertex ids are kept
+    void PurgeTombstones() {
+        if (m_num_tombstones == 0) {
+            return;
+        }
+
+        for (VertexId vert = 0; vert < m_edges.size(); ++vert) {
+            auto& arcs = m_edges[vert];
+            if (arcs.size() != static_cast<std::size_t>(m_degrees[vert])) {
+                arcs.erase(std::remove_if(arcs.begin(),
+                                          arcs.end(),
+                                          [](const AdjacencyArc& arc) {
+                                              return arc.dest == kNoVertex;
+                                          }),
+                           arcs.end());
+                arcs.shrink_to_fit();
+            }
+        }
+
+        m_num_tombstones = 0;
+    }
+
+    ///
+    /// \brief  Maps the keys of a bulk load to ids. Endpoints are sorted by key in parallel so
+    ///         each distinct key costs one map lookup; keys that are new get interned in order
+    ///         of first appearance, so the ids match those of an AddEdge loop.
+    template<typename EdgeIt>
+    void ResolveEndpoints(
+            WorkerTeam& team,
+            EdgeIt first,
+            std::size_t num_input,
+            std::vector<VertexId>& srcs,
+            std::vector<VertexId>& dsts) {
+        // Slot 2e is the source of edge e and slot 2e + 1 its destination. Keys are copied
+        // next to their slots so the sort compares contiguous memory.
+        auto id_of = [&](std::size_t slot) -> VertexId& {
+            return (slot % 2 == 0) ? srcs[slot / 2] : dsts[slot / 2];
+        };
+
+        std::vector<std::pair<DataT, std::size_t>> slots(2 * num_input);
+        team.ForEach(0, num_input, [&](unsigned, std::size_t lo, std::size_t hi) {
+            for (auto edge = lo; edge < hi; ++edge) {
+                slots[2 * edge] = std::make_pair(first[edge].src, 2 * edge);
+                slots[2 * edge + 1] = std::make_pair(first[edge].dst, 2 * edge + 1);
+            }
+        });
+
+        ParallelSort(team, slots.begin(), slots.end(), std::less<std::pair<DataT, std::size_t>>());
+
+        // Runs of equal keys, as [begin, end) positions in slots; a run's first slot is the
+        // key's first appearance
+        using Run = std::pair<std::size_t, std::size_t>;
+        std::vector<Run> missing;
+        for (std::size_t begin = 0, end = 0; begin < slots.size(); begin = end) {
+            const DataT& key = slots[begin].first;
+            end = begin + 1;
+            while ((end < slots.size()) && !(key < slots[end].first)) {
+                ++end;
+            }
+
+            VertexId id = m_vertices.Find(key);
+            if (id == kNoVertex) {
+                missing.push_back(std::make_pair(begin, end));
+                continue;
+            }
+
+            for (auto pos = begin; pos < end; ++pos) {
+                id_of(slots[pos].second) = id;
+            }
+        }
+
+        std::sort(missing.begin(), missing.end(), [&](const Run& lhs, const Run& rhs) {
+            return slots[lhs.first].second < slots[rhs.first].second;
+        });
+
+        for (const auto& run : missing) {
+            VertexId id = InternVertex(slots[run.first].first);
+            for (auto pos = run.first; pos < run.second; ++pos) {
+                id_of(slots[pos].second) = id;
+            }
         }
     }
 
     int m_num_vertices;
     int m_num_edges;
     bool m_is_directed;
-    bool m_terminate;
+    std::size_t m_num_tombstones;
+    double m_compaction_threshold;
 
     ProcVertexFn<DataT> m_vertex_early;
     ProcVertexFn<DataT> m_vertex_late;
     ProcEdgeFn<DataT> m_edge_proc;
 
-    EdgeList<DataT> m_edges;
-    DegreeList<DataT> m_degrees;
-    ParentList<DataT> m_parents;
-    TraversedList<DataT> m_discovered;
-    EntryList<DataT> m_timeclock;
-    std::stack<DataT> m_sorted;
+    VertexTable<DataT> m_vertices;
+    std::vector<std::vector<AdjacencyArc>> m_edges;
+    std::vector<int> m_degrees;
+
+    /// Search state behind the original, non-const entry points
+    SearchContext<DataT> m_search;
 };
@@ -0,0 +1,215 @@
+/*! -------------------------------------------------------------------------*\
+|   PageRank, degree and betweenness centrality over a frozen Graphis
+|   \see http://ilpubs.stanford.edu:8090/422/ (PageRank)
+|   \see Brandes, "A Faster Algorithm for Betweenness Centrality", J. Math. Sociol. 25(2), 2001
+\*---------------------------------------------------------------------------*/
+#pragma once
+
+#include "GraphisCSR.hpp"
+#include "GraphisParallel.hpp"
+
+#include <cmath>
+#include <vector>
+
+/// fn      BetweennessCentrality
+/// \brief  Brandes betweenness, unweighted: one BFS per source, the sources spread over
+///         num_threads workers (0 = all cores), each with its own scratch and score vectors that
+///         are summed at the end. Scores are in key order, unnormalized, and count each
+///         undirected pair once. num_samples > 0 runs only that many evenly spaced sources and
+///         scales the result up, an estimate for graphs too large for the exact O(VE) pass.
+template<typename DataT>
+std::vector<double> BetweennessCentrality(
+        const GraphisCSR<DataT>& graph, unsigned num_threads = 0, std::size_t num_samples = 0) {
+    const std::size_t num_verts = graph.GetNumVerts();
+    const auto& offsets = graph.GetOffsets();
+    const auto& targets = graph.GetTargets();
+    if ((num_samples == 0) || (num_samples > num_verts)) {
+        num_samples = num_verts;
+    }
+
+    /// \struct Scratch
+    /// \brief  Per-worker BFS state, reset only where the last source reached
+    struct Scratch {
+        explicit Scratch(std::size_t num_verts)
+                : depth(num_verts, -1), paths(num_verts, 0), dependency(num_verts, 0),
+                  scores(num_verts, 0) {}
+
+        std::vector<int> depth;
+        std::vector<double> paths;
+        std::vector<double> dependency;
+        std::vector<double> scores;
+        std::vector<VertexId> order;
+    };
+
+    WorkerTeam team(num_threads);
+    std::vector<Scratch> scratch(team.Size(), Scratch(num_verts));
+    team.ForEach(
+            0,
+            num_samples,
+            [&](unsigned worker, std::size_t lo, std::size_t hi) {
+                Scratch& mine = scratch[worker];
+                for (auto sample = lo; sample < hi; ++sample) {
+                    VertexId source = static_cast<VertexId>(sample * num_verts / num_samples);
+                    mine.order.assign(1, source);
+                    mine.depth[source] = 0;
+                    mine.paths[source] = 1;
+                    for (std::size_t next = 0; next < mine.order.size(); ++next) {
+                        VertexId vert = mine.order[next];
+                        for (auto edge = offsets[vert]; edge < offsets[vert + 1]; ++edge) {
+                            VertexId dest = targets[edge];
+                            if (mine.depth[dest] < 0) {
+                                mine.depth[dest] = mine.depth[vert] + 1;
+                                mine.order.push_back(dest);
+                            }
+
+                            if (mine.depth[dest] == mine.depth[vert] + 1) {
+                                mine.paths[dest] += mine.paths[vert];
+                            }
+                        }
+                    }
+
+                    // Successors instead of predecessor lists: dest follows vert on a shortest
+                    // path exactly when it is one level deeper
+                    for (auto slot = mine.order.size(); slot-- > 0;) {
+                        VertexId vert = mine.order[slot];
+                        double dependency = 0;
+                        for (auto edge = offsets[vert]; edge < offsets[vert + 1]; ++edge) {
+                            VertexId dest = targets[edge];
+                            if (mine.depth[dest] == mine.depth[vert] + 1) {
+                                dependency += (1 + mine.dependency[dest]) / mine.paths[dest];
+                            }
+                        }
+
+                        mine.dependency[vert] = dependency * mine.paths[vert];
+                        if (vert != source) {
+                            mine.scores[vert] += mine.dependency[vert];
+                        }
+                    }
+
+                    for (auto vert : mine.order) {
+                        mine.depth[vert] = -1;
+                        mine.paths[vert] = 0;
+                        mine.dependency[vert] = 0;
+                    }
+                }
+            },
+            1);
+
+    std::vector<double> scores(num_verts, 0);
+    const double scale = (graph.IsDirected() ? 1.0 : 0.5) * num_verts / std::max<std::size_t>(
+                                 1, num_samples);
+    for (const auto& mine : scratch) {
+        for (std::size_t vert = 0; vert < num_verts; ++vert) {
+            scores[vert] += mine.scores[vert] * scale;
+        }
+    }
+
+    return scores;
+}
+
+/// fn      DegreeCentrality
+/// \brief  Degree over n - 1, in key order; directed graphs count in- and out-degree
+template<typename DataT>
+std::vector<double> DegreeCentrality(const GraphisCSR<DataT>& graph) {
+    const std::size_t num_verts = graph.GetNumVerts();
+    const auto& offsets = graph.GetOffsets();
+    const auto& in_offsets = graph.GetInOffsets();
+    const double scale = (num_verts > 1) ? 1.0 / (num_verts - 1) : 1.0;
+
+    std::vector<double> centrality(num_verts);
+    for (std::size_t vert = 0; vert < num_verts; ++vert) {
+        EdgeOffset degree = offsets[vert + 1] - offsets[vert];
+        if (graph.IsDirected()) {
+            degree += in_offsets[vert + 1] - in_offsets[vert];
+        }
+
+        centrality[vert] = degree * scale;
+    }
+
+    return centrality;
+}
+
+/// fn      PageRank
+/// \brief  Pull-based power iteration, in key order: every vertex sums the contributions
+///         (rank / out-degree) of its in-neighbors from one contiguous array, so each pass
+///         is a gather with no atomics, split over num_threads workers (0 = all cores). Rank
+///         held by vertices without out-edges is spread evenly. Stops once an iteration moves
+///         the ranks by less than tolerance in total (L1) or after max_iterations; the number
+///         of iterations run goes to iterations if given.
+template<typename DataT>
+std::vector<double> PageRank(
+        const GraphisCSR<DataT>& graph,
+        double damping = 0.85,
+        double tolerance = 1e-6,
+        int max_iterations = 100,
+        int* iterations = nullptr,
+        unsigned num_threads = 0) {
+    const std::size_t num_verts = graph.GetNumVerts();
+    const auto& offsets = graph.GetOffsets();
+    const auto& in_offsets = graph.GetInOffsets();
+    const auto& in_sources = graph.GetInSources();
+
+    std::vector<double> ranks(num_verts, 1.0 / std::max<std::size_t>(1, num_verts));
+    std::vector<double> contributions(num_verts);
+    std::vector<double> inverse_degree(num_verts);
+    for (std::size_t vert = 0; vert < num_verts; ++vert) {
+        EdgeOffset degree = offsets[vert + 1] - offsets[vert];
+        inverse_degree[vert] = (degree != 0) ? 1.0 / degree : 0.0;
+    }
+
+    WorkerTeam team(num_threads);
+    std::vector<double> dangling(team.Size());
+    std::vector<double> change(team.Size());
+    int iteration = 0;
+    while (iteration < max_iterations) {
+        ++iteration;
+        std::fill(dangling.begin(), dangling.end(), 0.0);
+        team.ForEach(0, num_verts, [&](unsigned worker, std::size_t lo, std::size_t hi) {
+            double mass = 0;
+            for (auto vert = lo; vert < hi; ++vert) {
+                contributions[vert] = ranks[vert] * inverse_degree[vert];
+                mass += (inverse_degree[vert] == 0.0) ? ranks[vert] : 0.0;
+            }
+
+            dangling[worker] += mass;
+        });
+
+        double dangling_mass = 0;
+        for (auto mass : dangling) {
+            dangling_mass += mass;
+        }
+
+        const double base = (1.0 - damping + damping * dangling_mass) / num_verts;
+        std::fill(change.begin(), change.end(), 0.0);
+        team.ForEach(0, num_verts, [&](unsigned worker, std::size_t lo, std::size_t hi) {
+            double moved = 0;
+            for (auto vert = lo; vert < hi; ++vert) {
+                double sum = 0;
+                for (auto edge = in_offsets[vert]; edge < in_offsets[vert + 1]; ++edge) {
+                    sum += contributions[in_sources[edge]];
+                }
+
+                double rank = base + damping * sum;
+                moved += std::fabs(rank - ranks[vert]);
+                ranks[vert] = rank;
+            }
+
+            change[worker] += moved;
+        });
+
+        double total_change = 0;
+        for (auto moved : change) {
+            total_change += moved;
+        }
+
+        if (total_change < tolerance) {
+            break;
+        }
+    }
+
+    if (iterations != nullptr) {
+        *iterations = iteration;
+    }
+
+    return ranks;
+}
@@ -0,0 +1,628 @@
+/*! -------------------------------------------------------------------------*\
+|   Graphis micro-benchmarks
+|   \see https://github.com/google/benchmark
+\*---------------------------------------------------------------------------*/
+#include "Graphis.hpp"
+#include "GraphisAnalytics.hpp"
+#include "GraphisCSR.hpp"
+#include "GraphisMapped.hpp"
+#include "GraphisReader.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace {
+std::atomic<std::size_t> g_allocations(0);
+
+/// fn      CountedAllocate
+/// \brief  Shared by every replaced operator new, so that all of them count and all of them
+///         pair with the replaced operator deletes below
+void* CountedAllocate(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+}  // namespace
+
+///
+void* operator new(std::size_t size) {
+    if (void* block = CountedAllocate(size)) {
+        return block;
+    }
+
+    throw std::bad_alloc();
+}
+
+///
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+///
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size);
+}
+
+///
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size);
+}
+
+// GCC inlines these into callers and then flags free() on memory from operator new, although
+// the replaced operator new above comes from malloc
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+///
+void operator delete(void* block) noexcept {
+    std::free(block);
+}
+
+///
+void operator delete[](void* block) noexcept {
+    std::free(block);
+}
+
+///
+void operator delete(void* block, std::size_t) noexcept {
+    std::free(block);
+}
+
+///
+void operator delete[](void* block, std::size_t) noexcept {
+    std::free(block);
+}
+
+///
+void operator delete(void* block, const std::nothrow_t&) noexcept {
+    std::free(block);
+}
+
+///
+void operator delete[](void* block, const std::nothrow_t&) noexcept {
+    std::free(block);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+/// fn      MakeRandomGraph
+Graphis<int> MakeRandomGraph(int num_vertices, int num_edges) {
+    Graphis<int> graph;
+    std::mt19937 rng(20200518);
+    std::uniform_int_distribution<int> vertex(0, num_vertices - 1);
+    std::uniform_int_distribution<int> weight(1, 100);
+    for (int edge = 0; edge < num_edges; ++edge) {
+        graph.AddEdge(vertex(rng), vertex(rng), weight(rng));
+    }
+
+    return graph;
+}
+
+/// fn      SweepNeighbors
+/// \brief  One traversal touches every arc of every vertex through the given accessor and
+///         reports the heap allocations it cost
+template<typename SweepFn>
+void SweepNeighbors(benchmark::State& state, SweepFn sweep) {
+    Graphis<int> graph = MakeRandomGraph(state.range(0), 4 * state.range(0));
+    std::vector<int> vertices = graph.GetVertexList();
+
+    std::size_t allocations = 0;
+    for (auto _ : state) {
+        std::size_t before = g_allocations.load(std::memory_order_relaxed);
+        long checksum = 0;
+        for (auto vert : vertices) {
+            checksum += sweep(graph, vert);
+        }
+
+        allocations += g_allocations.load(std::memory_order_relaxed) - before;
+        benchmark::DoNotOptimize(checksum);
+    }
+
+    state.counters["allocs_per_traversal"] =
+            benchmark::Counter(allocations, benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * graph.GetNumEdges());
+}
+}  // namespace
+
+///
+static void BM_GetAdjacencyList(benchmark::State& state) {
+    SweepNeighbors(state, [](const Graphis<int>& graph, int vert) {
+        long sum = 0;
+        for (const auto& node : graph.GetAdjacencyList(vert)) {
+            sum += node.dest + node.weight;
+        }
+
+        return sum;
+    });
+}
+BENCHMARK(BM_GetAdjacencyList)->Arg(1 << 12)->Arg(1 << 16);
+
+///
+static void BM_GetAdjacentVertices(benchmark::State& state) {
+    SweepNeighbors(state, [](const Graphis<int>& graph, int vert) {
+        long sum = 0;
+        for (auto dest : graph.GetAdjacentVertices(vert)) {
+            sum += dest;
+        }
+
+        return sum;
+    });
+}
+BENCHMARK(BM_GetAdjacentVertices)->Arg(1 << 12)->Arg(1 << 16);
+
+///
+static void BM_GetNeighbors(benchmark::State& state) {
+    SweepNeighbors(state, [](const Graphis<int>& graph, int vert) {
+        long sum = 0;
+        for (const auto& neighbor : graph.GetNeighbors(vert)) {
+            sum += neighbor.dest + neighbor.weight;
+        }
+
+        return sum;
+    });
+}
+BENCHMARK(BM_GetNeighbors)->Arg(1 << 12)->Arg(1 << 16);
+
+/// fn      MakeEdgeList
+std::vector<WeightedEdge<int>> MakeEdgeList(int num_vertices, int num_edges) {
+    std::mt19937 rng(20200518);
+    std::uniform_int_distribution<int> vertex(0, num_vertices - 1);
+    std::uniform_int_distribution<int> weight(1, 100);
+    std::vector<WeightedEdge<int>> edges;
+    edges.reserve(num_edges);
+    for (int edge = 0; edge < num_edges; ++edge) {
+        edges.push_back(WeightedEdge<int>{vertex(rng), vertex(rng), weight(rng)});
+    }
+
+    return edges;
+}
+
+///
+static void BM_AddEdge(benchmark::State& state) {
+    std::vector<WeightedEdge<int>> edges = MakeEdgeList(state.range(0) / 8, state.range(0));
+    for (auto _ : state) {
+        Graphis<int> graph;
+        for (const auto& edge : edges) {
+            graph.AddEdge(edge.src, edge.dst, edge.weight);
+        }
+
+        benchmark::DoNotOptimize(graph.GetNumEdges());
+    }
+
+    state.SetItemsProcessed(state.iterations() * edges.size());
+}
+BENCHMARK(BM_AddEdge)->Arg(1 << 20);
+
+///
+static void BM_AddEdges(benchmark::State& state) {
+    std::vector<WeightedEdge<int>> edges = MakeEdgeList(state.range(0) / 8, state.range(0));
+    for (auto _ : state) {
+        Graphis<int> graph;
+        graph.AddEdges(edges);
+        benchmark::DoNotOptimize(graph.GetNumEdges());
+    }
+
+    state.SetItemsProcessed(state.iterations() * edges.size());
+}
+BENCHMARK(BM_AddEdges)->Arg(1 << 20);
+
+///
+/// \brief  Opening should cost the same whatever the file size; one lookup and one neighbor
+///         scan are included so the mapping is actually touched
+static void BM_OpenMapped(benchmark::State& state) {
+    const char* tmpdir = std::getenv("TMPDIR");
+    std::string path = std::string(tmpdir ? tmpdir : "/tmp") + "/graphis_bench.grmf";
+    {
+        std::ofstream out(path, std::ios::binary);
+        MappedGraphis<int>::Save(MakeRandomGraph(state.range(0) / 8, state.range(0)), out);
+    }
+
+    for (auto _ : state) {
+        MappedGraphis<int> graph = MappedGraphis<int>::Open(path);
+        VertexId vert = graph.FindId(0);
+        benchmark::DoNotOptimize(graph.GetOffsets()[vert + 1] - graph.GetOffsets()[vert]);
+    }
+
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_OpenMapped)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 20);
+
+/// fn      WriteDimacsFile
+/// \brief  Writes a random DIMACS file under TMPDIR and returns its path and size
+std::pair<std::string, std::size_t> WriteDimacsFile(int num_edges) {
+    const char* tmpdir = std::getenv("TMPDIR");
+    std::string path = std::string(tmpdir ? tmpdir : "/tmp") + "/graphis_bench.gr";
+
+    std::ofstream out(path, std::ios::binary);
+    out << "p sp " << num_edges / 8 << ' ' << num_edges << '\n';
+    for (const auto& edge : MakeEdgeList(num_edges / 8, num_edges)) {
+        out << "a " << edge.src << ' ' << edge.dst << ' ' << edge.weight << '\n';
+    }
+
+    return std::make_pair(path, static_cast<std::size_t>(out.tellp()));
+}
+
+///
+/// \brief  iostream extraction, for comparison with ParseEdgeList
+static void BM_ParseDimacsIostream(benchmark::State& state) {
+    auto file = WriteDimacsFile(state.range(0));
+    for (auto _ : state) {
+        std::ifstream in(file.first);
+        std::vector<WeightedEdge<int>> edges;
+        std::string tag;
+        for (std::string line; std::getline(in, line);) {
+            std::istringstream fields(line);
+            WeightedEdge<int> edge;
+            if ((fields >> tag >> edge.src >> edge.dst >> edge.weight) && (tag == "a")) {
+                edges.push_back(edge);
+            }
+        }
+
+        benchmark::DoNotOptimize(edges.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * file.second);
+    std::remove(file.first.c_str());
+}
+BENCHMARK(BM_ParseDimacsIostream)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+///
+/// \brief  range(1) is the number of threads parsing file slices
+static void BM_ParseEdgeList(benchmark::State& state) {
+    auto file = WriteDimacsFile(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+                ParseEdgeList<int>(file.first, EdgeFormat::EF_DIMACS, state.range(1)).data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * file.second);
+    std::remove(file.first.c_str());
+}
+BENCHMARK(BM_ParseEdgeList)
+        ->Args({1 << 20, 1})
+        ->Args({1 << 20, 4})
+        ->Unit(benchmark::kMillisecond);
+
+///
+/// \brief  range(0) picks the engine, range(1) the average degree
+static void BM_MinimumSpanningTree(benchmark::State& state) {
+    const int num_vertices = 1 << 14;
+    GraphisCSR<int> frozen =
+            MakeRandomGraph(num_vertices, num_vertices * state.range(1) / 2).Freeze();
+    auto kind = static_cast<SpanningKind>(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(frozen.MinimumSpanningTree(kind).weight);
+    }
+
+    state.SetItemsProcessed(state.iterations() * frozen.GetNumEdges());
+}
+BENCHMARK(BM_MinimumSpanningTree)
+        ->ArgsProduct({{static_cast<int>(SpanningKind::SK_PRIM),
+                        static_cast<int>(SpanningKind::SK_KRUSKAL),
+                        static_cast<int>(SpanningKind::SK_BORUVKA)},
+                       {4, 64}});
+
+///
+/// \brief  range(0) picks the engine, range(1) the average degree
+static void BM_AllPairsShortestPaths(benchmark::State& state) {
+    const int num_vertices = 1 << 10;
+    GraphisCSR<int> frozen =
+            MakeRandomGraph(num_vertices, num_vertices * state.range(1) / 2).Freeze();
+    auto kind = static_cast<AllPairsKind>(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(frozen.AllPairsShortestPaths(kind).GetData());
+    }
+
+    state.SetItemsProcessed(state.iterations() * frozen.GetNumVerts() * frozen.GetNumVerts());
+}
+BENCHMARK(BM_AllPairsShortestPaths)
+        ->ArgsProduct({{static_cast<int>(AllPairsKind::AK_FLOYD_WARSHALL),
+                        static_cast<int>(AllPairsKind::AK_JOHNSON)},
+                       {4, 256}})
+        ->Unit(benchmark::kMillisecond);
+
+///
+/// \brief  Serial binary-heap Dijkstra, for comparison with BM_DeltaStepping
+static void BM_DijkstraShortestPath(benchmark::State& state) {
+    Graphis<int> graph = MakeRandomGraph(state.range(0), 8 * state.range(0));
+    SearchContext<int> search;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(graph.DjikstaShortestPath(0, search).size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * graph.GetNumEdges());
+}
+BENCHMARK(BM_DijkstraShortestPath)->Arg(1 << 18)->Unit(benchmark::kMillisecond);
+
+///
+/// \brief  range(1) is the number of threads, range(2) the bucket width (0 = default)
+static void BM_DeltaStepping(benchmark::State& state) {
+    Graphis<int> graph = MakeRandomGraph(state.range(0), 8 * state.range(0));
+    SearchContext<int> search;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+                graph.DeltaSteppingShortestPath(0, search, state.range(2), state.range(1)).data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * graph.GetNumEdges());
+}
+BENCHMARK(BM_DeltaStepping)
+        ->ArgsProduct({{1 << 18}, {1, 4}, {0, 25}})
+        ->Unit(benchmark::kMillisecond);
+
+namespace {
+/// fn      GetTenMillionEdgeGraph
+/// \brief  Directed uniform random graph with 2^20 vertices and 10M edges, built once and
+///         shared by the analytics benchmarks
+const GraphisCSR<int>& GetTenMillionEdgeGraph() {
+    static const GraphisCSR<int> frozen = [] {
+        Graphis<int> graph(true);
+        graph.AddEdges(MakeEdgeList(1 << 20, 10000000));
+        return graph.Freeze();
+    }();
+
+    return frozen;
+}
+}  // namespace
+
+///
+/// \brief  range(0) is the number of threads; runs a fixed 20 iterations
+static void BM_PageRank(benchmark::State& state) {
+    const GraphisCSR<int>& frozen = GetTenMillionEdgeGraph();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PageRank(frozen, 0.85, 0.0, 20, nullptr, state.range(0)).data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * 20 * frozen.GetNumEdges());
+}
+BENCHMARK(BM_PageRank)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
+
+///
+static void BM_DegreeCentrality(benchmark::State& state) {
+    const GraphisCSR<int>& frozen = GetTenMillionEdgeGraph();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(DegreeCentrality(frozen).data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * frozen.GetNumVerts());
+}
+BENCHMARK(BM_DegreeCentrality)->Unit(benchmark::kMillisecond);
+
+///
+/// \brief  range(0) is the number of threads; 16 sampled sources, each a full BFS
+static void BM_BetweennessCentrality(benchmark::State& state) {
+    const GraphisCSR<int>& frozen = GetTenMillionEdgeGraph();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(BetweennessCentrality(frozen, state.range(0), 16).data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * 16 * frozen.GetNumEdges());
+}
+BENCHMARK(BM_BetweennessCentrality)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
+
+///
+/// \brief  range(0) picks the engine, range(1) the number of threads
+static void BM_StronglyConnectedComponents(benchmark::State& state) {
+    const GraphisCSR<int>& frozen = GetTenMillionEdgeGraph();
+    auto kind = static_cast<StrongKind>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+                frozen.StronglyConnectedComponents(kind, nullptr, state.range(1)).data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * frozen.GetNumEdges());
+}
+BENCHMARK(BM_StronglyConnectedComponents)
+        ->Args({static_cast<int>(StrongKind::SC_TARJAN), 1})
+        ->Args({static_cast<int>(StrongKind::SC_FORWARD_BACKWARD), 1})
+        ->Args({static_cast<int>(StrongKind::SC_FORWARD_BACKWARD), 4})
+        ->Unit(benchmark::kMillisecond);
+
+///
+/// \brief  range(0) is the number of threads; every edge points to a larger vertex
+static void BM_TopologicalLevels(benchmark::State& state) {
+    std::vector<WeightedEdge<int>> edges = MakeEdgeList(1 << 20, 1 << 23);
+    for (auto& edge : edges) {
+        edge = WeightedEdge<int>{
+                std::min(edge.src, edge.dst), std::max(edge.src, edge.dst) + 1, edge.weight};
+    }
+
+    Graphis<int> graph(true);
+    graph.AddEdges(edges);
+    GraphisCSR<int> frozen = graph.Freeze();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(frozen.TopologicalLevels(nullptr, state.range(0)).size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * frozen.GetNumEdges());
+}
+BENCHMARK(BM_TopologicalLevels)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
+
+///
+/// \brief  range(0) is the batch width, 0 for one BreadthFirstSearch per root
+static void BM_MultiSourceBreadthFirstSearch(benchmark::State& state) {
+    GraphisCSR<int> frozen = MakeRandomGraph(1 << 16, 1 << 19).Freeze();
+    const std::vector<int>& vertices = frozen.GetVertexList();
+    std::vector<int> roots(vertices.begin(), vertices.begin() + 512);
+    for (auto _ : state) {
+        std::size_t num_reached = 0;
+        if (state.range(0) == 0) {
+            for (auto root : roots) {
+                num_reached += frozen.BreadthFirstSearch(root).size();
+            }
+        } else {
+            std::vector<std::vector<int>> reached =
+                    (state.range(0) == 64) ? frozen.MultiSourceBreadthFirstSearch<64>(roots, 1)
+                                           : frozen.MultiSourceBreadthFirstSearch<256>(roots, 1);
+            for (const auto& one : reached) {
+                num_reached += one.size();
+            }
+        }
+
+        benchmark::DoNotOptimize(num_reached);
+    }
+
+    state.SetItemsProcessed(state.iterations() * roots.size());
+}
+BENCHMARK(BM_MultiSourceBreadthFirstSearch)
+        ->Arg(0)
+        ->Arg(64)
+        ->Arg(256)
+        ->Unit(benchmark::kMillisecond);
+
+namespace {
+/// fn      GetScatteredCommunityGraph
+/// \brief  Directed graph of 2^19 vertices in communities of 256, most arcs staying inside
+///         one, with the keys shuffled so that key order hides the communities; built once
+const GraphisCSR<int>& GetScatteredCommunityGraph() {
+    static const GraphisCSR<int> frozen = [] {
+        const int num_vertices = 1 << 19;
+        std::mt19937 rng(20200518);
+        std::vector<int> keys(num_vertices);
+        std::iota(keys.begin(), keys.end(), 0);
+        std::shuffle(keys.begin(), keys.end(), rng);
+
+        std::uniform_int_distribution<int> local(0, 255);
+        std::uniform_int_distribution<int> global(0, num_vertices - 1);
+        std::vector<WeightedEdge<int>> edges;
+        edges.reserve(8 * num_vertices);
+        for (int vert = 0; vert < num_vertices; ++vert) {
+            for (int arc = 0; arc < 8; ++arc) {
+                int dest = (arc < 7) ? vert / 256 * 256 + local(rng) : global(rng);
+                edges.push_back(WeightedEdge<int>{keys[vert], keys[dest], 1});
+            }
+        }
+
+        Graphis<int> graph(true);
+        graph.AddEdges(edges);
+        return graph.Freeze();
+    }();
+
+    return frozen;
+}
+}  // namespace
+
+///
+/// \brief  range(0) picks the ordering
+static void BM_Reorder(benchmark::State& state) {
+    const GraphisCSR<int>& frozen = GetScatteredCommunityGraph();
+    auto kind = static_cast<ReorderKind>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(frozen.Reorder(kind).GetNumEdges());
+    }
+
+    state.SetItemsProcessed(state.iterations() * frozen.GetNumEdges());
+}
+BENCHMARK(BM_Reorder)
+        ->Arg(static_cast<int>(ReorderKind::RK_DEGREE))
+        ->Arg(static_cast<int>(ReorderKind::RK_REVERSE_CUTHILL_MCKEE))
+        ->Arg(static_cast<int>(ReorderKind::RK_GORDER))
+        ->Unit(benchmark::kMillisecond);
+
+///
+/// \brief  range(0) picks the ordering, -1 for key order; range(1) runs BFS (0) or PageRank (1)
+static void BM_ReorderedTraversal(benchmark::State& state) {
+    const GraphisCSR<int>& scattered = GetScatteredCommunityGraph();
+    GraphisCSR<int> frozen = (state.range(0) < 0)
+                                     ? scattered
+                                     : scattered.Reorder(static_cast<ReorderKind>(state.range(0)));
+    const int root = frozen.GetKey(0);
+    for (auto _ : state) {
+        if (state.range(1) == 0) {
+            benchmark::DoNotOptimize(frozen.ParallelBreadthFirstSearch(root, nullptr, 1).size());
+        } else {
+            benchmark::DoNotOptimize(PageRank(frozen, 0.85, 0.0, 10, nullptr, 1).data());
+        }
+    }
+
+    LocalityStats locality = frozen.GetLocality();
+    state.counters["average_log_gap"] = locality.average_log_gap;
+    state.counters["near_fraction"] = locality.near_fraction;
+    state.SetItemsProcessed(state.iterations() * frozen.GetNumEdges());
+}
+BENCHMARK(BM_ReorderedTraversal)
+        ->ArgsProduct({{-1,
+                        static_cast<int>(ReorderKind::RK_DEGREE),
+                        static_cast<int>(ReorderKind::RK_REVERSE_CUTHILL_MCKEE),
+                        static_cast<int>(ReorderKind::RK_GORDER)},
+                       {0, 1}})
+        ->Unit(benchmark::kMillisecond);
+
+/// Counters behind the function pointer hooks, which cannot carry state of their own
+long g_hook_vertices = 0;
+long g_hook_edges = 0;
+
+///
+void CountVertex(Graphis<int>&, int) {
+    ++g_hook_vertices;
+}
+
+///
+void CountEdge(Graphis<int>&, int, int) {
+    ++g_hook_edges;
+}
+
+///
+/// \brief  Depth-first search through the stored function pointers; range(1) == 1 installs
+///         counting hooks, 0 keeps the default no-op ones
+static void BM_TraversalFunctionPointers(benchmark::State& state) {
+    Graphis<int> graph = MakeRandomGraph(state.range(0), 4 * state.range(0));
+    if (state.range(1)) {
+        graph.SetProcessVertexEarly(CountVertex);
+        graph.SetProcessEdgeFn(CountEdge);
+    }
+
+    for (auto _ : state) {
+        g_hook_vertices = 0;
+        g_hook_edges = 0;
+        benchmark::DoNotOptimize(graph.DepthFirstSearch(0).size());
+        benchmark::DoNotOptimize(g_hook_vertices + g_hook_edges);
+    }
+
+    state.SetItemsProcessed(state.iterations() * graph.GetNumEdges());
+}
+BENCHMARK(BM_TraversalFunctionPointers)->ArgsProduct({{1 << 16}, {0, 1}});
+
+///
+/// \brief  The same search with inlined visitor hooks; range(1) == 1 counts as above
+static void BM_TraversalVisitor(benchmark::State& state) {
+    Graphis<int> graph = MakeRandomGraph(state.range(0), 4 * state.range(0));
+    SearchContext<int> search;
+    long vertices = 0;
+    long edges = 0;
+    auto counter = MakeVisitor(
+            [&](int) { ++vertices; }, [&](int, int) { ++edges; }, [](int) {});
+
+    for (auto _ : state) {
+        vertices = 0;
+        edges = 0;
+        if (state.range(1)) {
+            benchmark::DoNotOptimize(graph.DepthFirstSearch(0, search, counter).size());
+        } else {
+            benchmark::DoNotOptimize(graph.DepthFirstSearch(0, search).size());
+        }
+
+        benchmark::DoNotOptimize(vertices + edges);
+    }
+
+    state.SetItemsProcessed(state.iterations() * graph.GetNumEdges());
+}
+BENCHMARK(BM_TraversalVisitor)->ArgsProduct({{1 << 16}, {0, 1}});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,574 @@
+/*! -------------------------------------------------------------------------*\
+|   Contraction hierarchies for repeated point-to-point queries on a static Graphis
+|   \see Geisberger et al., "Contraction Hierarchies: Faster and Simpler Hierarchical
+|        Routing in Road Networks", WEA 2008
+\*---------------------------------------------------------------------------*/
+#pragma once
+
+#include "GraphisCSR.hpp"
+#include "GraphisHeap.hpp"
+#include "GraphisSerialize.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+
+/// \struct HierarchyArc
+/// \brief  Edge of a contraction hierarchy; shortcuts record the contracted vertex they bypass
+struct HierarchyArc {
+    VertexId vertex;
+    int weight;
+    VertexId middle;
+};
+
+/// \class  ContractionHierarchy
+/// \brief  Vertices are contracted in edge-difference order, adding a shortcut whenever a
+///         bounded witness search finds no path at least as short around the contracted
+///         vertex. Queries run a bidirectional Dijkstra that only climbs to higher ranks.
+template<typename DataT>
+class ContractionHierarchy {
+public:
+    /// \class  Workspace
+    /// \brief  Reusable query state; one per thread lets a single hierarchy serve concurrent
+    ///         queries without per-query O(V) allocation
+    class Workspace {
+        friend class ContractionHierarchy<DataT>;
+
+    public:
+        ///
+        explicit Workspace(const ContractionHierarchy<DataT>& hierarchy)
+                : m_forward(hierarchy.GetNumVerts()), m_backward(hierarchy.GetNumVerts()) {}
+
+    private:
+        /// \struct Side
+        struct Side {
+            ///
+            explicit Side(std::size_t num_vertices)
+                    : distances(num_vertices, kUnreachable)
+                    , parents(num_vertices, kNoVertex)
+                    , kew(num_vertices) {}
+
+            ///
+            void Reset() {
+                for (auto vert : touched) {
+                    distances[vert] = kUnreachable;
+                    parents[vert] = kNoVertex;
+                }
+
+                touched.clear();
+                kew.Clear();
+            }
+
+            ///
+            void Relax(VertexId vert, VertexId parent, int distance) {
+                if (distances[vert] == kUnreachable) {
+                    touched.push_back(vert);
+                }
+
+                distances[vert] = distance;
+                parents[vert] = parent;
+                kew.Push(vert, distance);
+            }
+
+            std::vector<int> distances;
+            std::vector<VertexId> parents;
+            std::vector<VertexId> touched;
+            IndexedHeap<int> kew;
+        };
+
+        Side m_forward;
+        Side m_backward;
+    };
+
+    ///
+    ContractionHierarchy() : m_is_directed(false), m_fwd_offsets(1, 0), m_bwd_offsets(1, 0) {}
+
+    ///
+    explicit ContractionHierarchy(const Graphis<DataT>& graph)
+            : ContractionHierarchy(graph.Freeze()) {}
+
+    ///
+    /// \brief  FindId searches the keys, so a GraphisCSR::Reorder copy throws
+    ///         std::invalid_argument
+    explicit ContractionHierarchy(const GraphisCSR<DataT>& graph)
+            : m_is_directed(graph.IsDirected()), m_keys(graph.GetVertexList()) {
+        if (!graph.IsKeyOrdered()) {
+            throw std::invalid_argument("Contraction hierarchies need vertices in key order");
+        }
+
+        Contraction contraction(graph);
+        contraction.Run();
+
+        m_ranks = contraction.ranks;
+        m_fwd_offsets.push_back(0);
+        m_bwd_offsets.push_back(0);
+        for (VertexId vert = 0; vert < GetNumVerts(); ++vert) {
+            for (const auto& arc : contraction.out[vert]) {
+                if (m_ranks[arc.vertex] > m_ranks[vert]) {
+                    m_fwd_arcs.push_back(arc);
+                }
+            }
+
+            for (const auto& arc : contraction.in[vert]) {
+                if (m_ranks[arc.vertex] > m_ranks[vert]) {
+                    m_bwd_arcs.push_back(arc);
+                }
+            }
+
+            m_fwd_offsets.push_back(m_fwd_arcs.size());
+            m_bwd_offsets.push_back(m_bwd_arcs.size());
+        }
+    }
+
+    ///
+    VertexId FindId(const DataT& key) const {
+        auto keyit = std::lower_bound(m_keys.begin(), m_keys.end(), key);
+        if ((keyit == m_keys.end()) || (key < *keyit)) {
+            return kNoVertex;
+        }
+
+        return static_cast<VertexId>(keyit - m_keys.begin());
+    }
+
+    ///
+    std::size_t GetNumShortcuts() const {
+        std::size_t shortcuts = 0;
+        for (const auto* arcs : {&m_fwd_arcs, &m_bwd_arcs}) {
+            for (const auto& arc : *arcs) {
+                shortcuts += (arc.middle != kNoVertex) ? 1 : 0;
+            }
+        }
+
+        return shortcuts;
+    }
+
+    ///
+    std::size_t GetNumVerts() const {
+        return m_keys.size();
+    }
+
+    ///
+    bool IsDirected() const {
+        return m_is_directed;
+    }
+
+    ///
+    /// \brief  Reads a hierarchy written by Save; throws std::runtime_error on malformed input
+    static ContractionHierarchy Load(std::istream& in) {
+        if ((ReadPod<std::uint32_t>(in) != kMagic) || (ReadPod<std::uint32_t>(in) != kVersion)) {
+            throw std::runtime_error("Not a contraction hierarchy stream");
+        }
+
+        ContractionHierarchy hierarchy;
+        hierarchy.m_is_directed = ReadPod<std::uint8_t>(in) != 0;
+        hierarchy.m_keys = KeyCodec<DataT>::Read(in);
+        hierarchy.m_ranks = ReadVector<VertexId>(in);
+        hierarchy.m_fwd_offsets = ReadVector<EdgeOffset>(in);
+        hierarchy.m_fwd_arcs = ReadVector<HierarchyArc>(in);
+        hierarchy.m_bwd_offsets = ReadVector<EdgeOffset>(in);
+        hierarchy.m_bwd_arcs = ReadVector<HierarchyArc>(in);
+
+        const auto& ranks = hierarchy.m_ranks;
+        bool valid = (ranks.size() == hierarchy.m_keys.size())
+                     && std::is_sorted(hierarchy.m_keys.begin(), hierarchy.m_keys.end())
+                     && IsPermutation(ranks)
+                     && IsValidSide(hierarchy.m_fwd_offsets, hierarchy.m_fwd_arcs, ranks)
+                     && IsValidSide(hierarchy.m_bwd_offsets, hierarchy.m_bwd_arcs, ranks);
+        if (!valid) {
+            throw std::runtime_error("Malformed contraction hierarchy stream");
+        }
+
+        return hierarchy;
+    }
+
+    ///
+    void Save(std::ostream& out) const {
+        WritePod(out, kMagic);
+        WritePod(out, kVersion);
+        WritePod<std::uint8_t>(out, m_is_directed ? 1 : 0);
+        KeyCodec<DataT>::Write(out, m_keys);
+        WriteVector(out, m_ranks);
+        WriteVector(out, m_fwd_offsets);
+        WriteVector(out, m_fwd_arcs);
+        WriteVector(out, m_bwd_offsets);
+        WriteVector(out, m_bwd_arcs);
+    }
+
+    ///
+    PathResult<DataT> ShortestPath(const DataT& src, const DataT& dst) const {
+        Workspace workspace(*this);
+        return ShortestPath(src, dst, workspace);
+    }
+
+    ///
+    PathResult<DataT> ShortestPath(const DataT& src, const DataT& dst, Workspace& workspace) const {
+        PathResult<DataT> result;
+        VertexId source = FindId(src);
+        VertexId target = FindId(dst);
+        if ((source == kNoVertex) || (target == kNoVertex)) {
+            return result;
+        }
+
+        auto& forward = workspace.m_forward;
+        auto& backward = workspace.m_backward;
+        forward.Reset();
+        backward.Reset();
+        forward.Relax(source, kNoVertex, 0);
+        backward.Relax(target, kNoVertex, 0);
+
+        int best = kUnreachable;
+        VertexId meet = kNoVertex;
+        for (;;) {
+            bool forward_live = !forward.kew.IsEmpty()
+                                && (forward.kew.GetKey(forward.kew.Top()) < best);
+            bool backward_live = !backward.kew.IsEmpty()
+                                 && (backward.kew.GetKey(backward.kew.Top()) < best);
+            if (!forward_live && !backward_live) {
+                break;
+            }
+
+            bool go_forward = forward_live
+                              && (!backward_live
+                                  || (forward.kew.GetKey(forward.kew.Top())
+                                      <= backward.kew.GetKey(backward.kew.Top())));
+            auto& side = go_forward ? forward : backward;
+            const auto& other = go_forward ? backward : forward;
+            const auto& offsets = go_forward ? m_fwd_offsets : m_bwd_offsets;
+            const auto& arcs = go_forward ? m_fwd_arcs : m_bwd_arcs;
+
+            VertexId current = side.kew.PopMin();
+            ++result.settled;
+            if ((other.distances[current] != kUnreachable)
+                && (side.distances[current] + other.distances[current] < best)) {
+                best = side.distances[current] + other.distances[current];
+                meet = current;
+            }
+
+            for (auto arc = offsets[current]; arc < offsets[current + 1]; ++arc) {
+                VertexId candidate = arcs[arc].vertex;
+                int distance = side.distances[current] + arcs[arc].weight;
+                if (distance < side.distances[candidate]) {
+                    side.Relax(candidate, current, distance);
+                }
+            }
+        }
+
+        if (meet != kNoVertex) {
+            std::vector<VertexId> coarse;
+            for (VertexId vert = meet; vert != kNoVertex; vert = forward.parents[vert]) {
+                coarse.push_back(vert);
+            }
+
+            std::reverse(coarse.begin(), coarse.end());
+            for (VertexId vert = backward.parents[meet]; vert != kNoVertex;
+                 vert = backward.parents[vert]) {
+                coarse.push_back(vert);
+            }
+
+            result.distance = best;
+            result.path.push_back(m_keys[coarse.front()]);
+            for (std::size_t hop = 0; hop + 1 < coarse.size(); ++hop) {
+                UnpackArc(coarse[hop], coarse[hop + 1], result.path);
+            }
+        }
+
+        return result;
+    }
+
+private:
+    static constexpr std::uint32_t kMagic = 0x48435247;  // "GRCH"
+    static constexpr std::uint32_t kVersion = 1;
+
+    /// Witness searches give up after settling this many vertices and add the shortcut
+    static constexpr std::size_t kWitnessSettleLimit = 500;
+
+    /// \struct Contraction
+    /// \brief  Preprocessing state: the remaining graph with shortcuts, plus witness search
+    ///         scratch space reused across searches
+    struct Contraction {
+        ///
+        explicit Contraction(const GraphisCSR<DataT>& graph)
+                : out(graph.GetNumVerts())
+                , in(graph.GetNumVerts())
+                , ranks(graph.GetNumVerts(), kNoVertex)
+                , contracted(graph.GetNumVerts(), false)
+                , deleted_neighbors(graph.GetNumVerts(), 0)
+                , witness(graph.GetNumVerts(), kUnreachable)
+                , kew(graph.GetNumVerts()) {
+            const auto& offsets = graph.GetOffsets();
+            for (VertexId vert = 0; vert < graph.GetNumVerts(); ++vert) {
+                for (auto edge = offsets[vert]; edge < offsets[vert + 1]; ++edge) {
+                    VertexId target = graph.GetTargets()[edge];
+                    if (target != vert) {
+                        AddArc(vert, target, graph.GetWeights()[edge], kNoVertex);
+                    }
+                }
+            }
+        }
+
+        ///
+        /// \brief  Adds src->dst, or lowers the weight of an existing src->dst arc
+        void AddArc(VertexId src, VertexId dst, int weight, VertexId middle) {
+            RelaxArc(out[src], dst, weight, middle);
+            RelaxArc(in[dst], src, weight, middle);
+        }
+
+        ///
+        /// \brief  Returns the number of shortcuts contracting vert needs, adding them unless
+        ///         simulating
+        int Contract(VertexId vert, bool simulate) {
+            int shortcuts = 0;
+            for (const auto& incoming : in[vert]) {
+                if (contracted[incoming.vertex]) {
+                    continue;
+                }
+
+                int max_distance = -1;
+                for (const auto& outgoing : out[vert]) {
+                    if (!contracted[outgoing.vertex] && (outgoing.vertex != incoming.vertex)) {
+                        max_distance =
+                                std::max(max_distance, incoming.weight + outgoing.weight);
+                    }
+                }
+
+                if (max_distance < 0) {
+                    continue;
+                }
+
+                WitnessSearch(incoming.vertex, vert, max_distance);
+                for (const auto& outgoing : out[vert]) {
+                    int distance = incoming.weight + outgoing.weight;
+                    if (!contracted[outgoing.vertex] && (outgoing.vertex != incoming.vertex)
+                        && (witness[outgoing.vertex] > distance)) {
+                        ++shortcuts;
+                        if (!simulate) {
+                            shortcut_queue.push_back(
+                                    std::make_pair(incoming.vertex, HierarchyArc{
+                                            outgoing.vertex, distance, vert}));
+                        }
+                    }
+                }
+
+                ResetWitness();
+            }
+
+            // Shortcuts are added after the scan so in[vert]/out[vert] stay stable above
+            for (const auto& shortcut : shortcut_queue) {
+                AddArc(shortcut.first,
+                       shortcut.second.vertex,
+                       shortcut.second.weight,
+                       shortcut.second.middle);
+            }
+
+            shortcut_queue.clear();
+            return shortcuts;
+        }
+
+        ///
+        int Priority(VertexId vert) {
+            int removed = 0;
+            for (const auto* arcs : {&in[vert], &out[vert]}) {
+                for (const auto& arc : *arcs) {
+                    removed += contracted[arc.vertex] ? 0 : 1;
+                }
+            }
+
+            return Contract(vert, true) - removed + deleted_neighbors[vert];
+        }
+
+        ///
+        void RelaxArc(std::vector<HierarchyArc>& arcs, VertexId vert, int weight, VertexId middle) {
+            for (auto& arc : arcs) {
+                if (arc.vertex == vert) {
+                    if (weight < arc.weight) {
+                        arc.weight = weight;
+                        arc.middle = middle;
+                    }
+
+                    return;
+                }
+            }
+
+            arcs.push_back(HierarchyArc{vert, weight, middle});
+        }
+
+        ///
+        void ResetWitness() {
+            for (auto vert : touched) {
+                witness[vert] = kUnreachable;
+            }
+
+            touched.clear();
+            kew.Clear();
+        }
+
+        ///
+        /// \brief  Contracts every vertex, lazily re-evaluating priorities as neighbors go
+        void Run() {
+            using OrderEntry = std::pair<int, VertexId>;
+            std::priority_queue<OrderEntry, std::vector<OrderEntry>, std::greater<OrderEntry>>
+                    order;
+            for (VertexId vert = 0; vert < out.size(); ++vert) {
+                order.push(std::make_pair(Priority(vert), vert));
+            }
+
+            VertexId next_rank = 0;
+            while (!order.empty()) {
+                VertexId vert = order.top().second;
+                order.pop();
+
+                int priority = Priority(vert);
+                if (!order.empty() && (priority > order.top().first)) {
+                    order.push(std::make_pair(priority, vert));
+                    continue;
+                }
+
+                Contract(vert, false);
+                contracted[vert] = true;
+                ranks[vert] = next_rank++;
+                for (const auto* arcs : {&in[vert], &out[vert]}) {
+                    for (const auto& arc : *arcs) {
+                        ++deleted_neighbors[arc.vertex];
+                    }
+                }
+            }
+        }
+
+        ///
+        /// \brief  Bounded Dijkstra from src over uncontracted vertices other than skip
+        void WitnessSearch(VertexId src, VertexId skip, int max_distance) {
+            witness[src] = 0;
+            touched.push_back(src);
+            kew.Push(src, 0);
+
+            std::size_t settled = 0;
+            while (!kew.IsEmpty() && (settled++ < kWitnessSettleLimit)) {
+                VertexId current = kew.PopMin();
+                if (witness[current] > max_distance) {
+                    break;
+                }
+
+                for (const auto& arc : out[current]) {
+                    if (contracted[arc.vertex] || (arc.vertex == skip)) {
+                        continue;
+                    }
+
+                    int distance = witness[current] + arc.weight;
+                    if (distance < witness[arc.vertex]) {
+                        if (witness[arc.vertex] == kUnreachable) {
+                            touched.push_back(arc.vertex);
+                        }
+
+                        witness[arc.vertex] = distance;
+                        kew.Push(arc.vertex, distance);
+                    }
+                }
+            }
+        }
+
+        std::vector<std::vector<HierarchyArc>> out;
+        std::vector<std::vector<HierarchyArc>> in;
+        std::vector<VertexId> ranks;
+        std::vector<bool> contracted;
+        std::vector<int> deleted_neighbors;
+        std::vector<int> witness;
+        std::vector<VertexId> touched;
+        std::vector<std::pair<VertexId, HierarchyArc>> shortcut_queue;
+        IndexedHeap<int> kew;
+    };
+
+    ///
+    /// \brief  True if ranks holds every value in [0, n) exactly once
+    static bool IsPermutation(const std::vector<VertexId>& ranks) {
+        std::vector<bool> seen(ranks.size(), false);
+        for (auto rank : ranks) {
+            if ((rank >= ranks.size()) || seen[rank]) {
+                return false;
+            }
+
+            seen[rank] = true;
+        }
+
+        return true;
+    }
+
+    ///
+    /// \brief  Load's check of one direction's arrays: n + 1 rising offsets that end at the
+    ///         arc count, and arcs that climb from their owner to a higher rank. A shortcut's
+    ///         middle must rank below both ends, so unpacking always reaches original edges.
+    static bool IsValidSide(
+            const std::vector<EdgeOffset>& offsets,
+            const std::vector<HierarchyArc>& arcs,
+            const std::vector<VertexId>& ranks) {
+        const std::size_t num_verts = ranks.size();
+        if ((offsets.size() != num_verts + 1) || (offsets.front() != 0)
+            || (offsets.back() != arcs.size())) {
+            return false;
+        }
+
+        for (std::size_t vert = 0; vert < num_verts; ++vert) {
+            if (offsets[vert] > offsets[vert + 1]) {
+                return false;
+            }
+
+            for (auto edge = offsets[vert]; edge < offsets[vert + 1]; ++edge) {
+                const HierarchyArc& arc = arcs[edge];
+                if ((arc.vertex >= num_verts) || (ranks[arc.vertex] <= ranks[vert])) {
+                    return false;
+                }
+
+                if ((arc.middle != kNoVertex)
+                    && ((arc.middle >= num_verts) || (ranks[arc.middle] >= ranks[vert]))) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    ///
+    /// \brief  Returns the vertex a src->dst hierarchy arc bypasses, kNoVertex for an original edge
+    VertexId FindMiddle(VertexId src, VertexId dst) const {
+        bool upward = m_ranks[dst] > m_ranks[src];
+        VertexId owner = upward ? src : dst;
+        VertexId other = upward ? dst : src;
+        const auto& offsets = upward ? m_fwd_offsets : m_bwd_offsets;
+        const auto& arcs = upward ? m_fwd_arcs : m_bwd_arcs;
+        for (auto arc = offsets[owner]; arc < offsets[owner + 1]; ++arc) {
+            if (arcs[arc].vertex == other) {
+                return arcs[arc].middle;
+            }
+        }
+
+        return kNoVertex;
+    }
+
+    ///
+    /// \brief  Appends the original vertices along src->dst, excluding src
+    void UnpackArc(VertexId src, VertexId dst, std::vector<DataT>& path) const {
+        std::stack<std::pair<VertexId, VertexId>> pending;
+        pending.push(std::make_pair(src, dst));
+        while (!pending.empty()) {
+            auto arc = pending.top();
+            pending.pop();
+
+            VertexId middle = FindMiddle(arc.first, arc.second);
+            if (middle == kNoVertex) {
+                path.push_back(m_keys[arc.second]);
+            } else {
+                pending.push(std::make_pair(middle, arc.second));
+                pending.push(std::make_pair(arc.first, middle));
+            }
+        }
+    }
+
+    bool m_is_directed;
+    std::vector<DataT> m_keys;
+    std::vector<VertexId> m_ranks;
+    std::vector<EdgeOffset> m_fwd_offsets;
+    std::vector<HierarchyArc> m_fwd_arcs;
+    std::vector<EdgeOffset> m_bwd_offsets;
+    std::vector<HierarchyArc> m_bwd_arcs;
+};
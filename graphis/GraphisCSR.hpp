@@ -0,0 +1,1787 @@
+/*! -------------------------------------------------------------------------*\
+|   Frozen compressed sparse row (CSR) graph representation
+|   \see https://en.wikipedia.org/wiki/Sparse_matrix#Compressed_sparse_row_(CSR,_CRS_or_Yale_format)
+\*---------------------------------------------------------------------------*/
+#pragma once
+
+#include "Graphis.hpp"
+#include "GraphisHeap.hpp"
+#include "GraphisParallel.hpp"
+#include "GraphisUnionFind.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+/// \struct LocalityStats
+/// \brief  How far apart the ids at the two ends of an arc are. Per-vertex arrays read along
+///         arcs stay in L1 when gaps are within a cache line (8 doubles) and in the last level
+///         cache when the average log gap is small; bandwidth is the largest gap.
+struct LocalityStats {
+    double average_gap = 0;
+    double average_log_gap = 0;
+    double near_fraction = 0;
+    std::size_t bandwidth = 0;
+};
+
+/// \class  GraphisCSR
+/// \brief  Immutable snapshot of a Graphis. Vertices are renumbered 0..n-1 in key order, and the
+///         out-edges of vertex v occupy [offsets[v], offsets[v + 1]) of the target/weight arrays,
+///         in the same order Graphis::GetAdjacencyList reports them. Directed graphs also keep
+///         the transposed arrays for algorithms that pull along in-edges; undirected graphs
+///         share one set of arrays for both directions. A Reorder copy numbers its vertices
+///         for locality instead; "key order" for its results means GetVertexList order.
+template<typename DataT>
+class GraphisCSR {
+public:
+    ///
+    GraphisCSR() : m_is_directed(false), m_offsets(1, 0), m_in_offsets(1, 0) {}
+
+    ///
+    /// \brief  Graphis ids are in insertion order, so they are remapped to key order here
+    explicit GraphisCSR(const Graphis<DataT>& graph) : m_is_directed(graph.IsDirected()) {
+        std::vector<VertexId> ordered = graph.m_vertices.GetOrderedIds();
+        std::vector<VertexId> renumbered(graph.m_vertices.Size(), kNoVertex);
+        m_keys.reserve(ordered.size());
+        for (VertexId rank = 0; rank < ordered.size(); ++rank) {
+            renumbered[ordered[rank]] = rank;
+            m_keys.push_back(graph.m_vertices.GetKey(ordered[rank]));
+        }
+
+        m_offsets.reserve(ordered.size() + 1);
+        m_targets.reserve(graph.m_num_edges);
+        m_weights.reserve(graph.m_num_edges);
+        m_offsets.push_back(0);
+        for (auto vert : ordered) {
+            for (const auto& arc : graph.GetArcs(vert)) {
+                m_targets.push_back(renumbered[arc.dest]);
+                m_weights.push_back(arc.weight);
+            }
+
+            m_offsets.push_back(m_targets.size());
+        }
+
+        BuildInEdges();
+    }
+
+    ///
+    /// \brief  Shortest distances between every pair of vertices, rows and columns in key order,
+    ///         on num_threads workers (0 = all cores). Negative weights are allowed as long as
+    ///         distances stay within +-2^29; a negative cycle throws std::runtime_error.
+    DistanceMatrix AllPairsShortestPaths(
+            AllPairsKind kind = AllPairsKind::AK_JOHNSON, unsigned num_threads = 0) const {
+        WorkerTeam team(num_threads);
+        if (kind == AllPairsKind::AK_FLOYD_WARSHALL) {
+            return DoFloydWarshall(team);
+        }
+
+        return DoJohnson(team);
+    }
+
+    ///
+    std::vector<DataT> BreadthFirstSearch(const DataT& root) const {
+        std::vector<DataT> bfs;
+        std::vector<bool> discovered(GetNumVerts(), false);
+        DoBreadthFirstSearch(FindId(root), discovered, bfs);
+        return bfs;
+    }
+
+    ///
+    /// \brief  Unlike Graphis::ConnectedComponents, the visited set is shared across components,
+    ///         so every vertex is searched exactly once
+    ComponentList<DataT> ConnectedComponents() const {
+        auto component_num = 0;
+        ComponentList<DataT> components;
+
+        std::vector<bool> discovered(GetNumVerts(), false);
+        for (VertexId vert = 0; vert < GetNumVerts(); ++vert) {
+            if (!discovered[vert]) {
+                ++component_num;
+                DoBreadthFirstSearch(vert, discovered, components[component_num]);
+            }
+        }
+
+        return components;
+    }
+
+    ///
+    std::vector<DataT> DepthFirstSearch(const DataT& root) const {
+        std::vector<DataT> dfs;
+        std::vector<bool> discovered(GetNumVerts(), false);
+        DoDepthFirstSearch(
+                FindId(root),
+                discovered,
+                [&](VertexId vert) { dfs.push_back(m_keys[vert]); },
+                [](VertexId) {});
+
+        return dfs;
+    }
+
+    ///
+    /// \brief  Returns vertices in the order they are settled; ties settle in key order
+    std::vector<DataT> DjikstaShortestPath(
+            const DataT& root, ParentList<DataT>* parents = nullptr) const {
+        return DoSpanningSearch(root, parents, [](int distance, int weight) {
+            return distance + weight;
+        });
+    }
+
+    ///
+    VertexId FindId(const DataT& key) const {
+        if (!m_key_order.empty()) {
+            auto idit = std::lower_bound(
+                    m_key_order.begin(), m_key_order.end(), key, [&](VertexId id, const DataT& k) {
+                        return m_keys[id] < k;
+                    });
+            return ((idit == m_key_order.end()) || (key < m_keys[*idit])) ? kNoVertex : *idit;
+        }
+
+        auto keyit = std::lower_bound(m_keys.begin(), m_keys.end(), key);
+        if ((keyit == m_keys.end()) || (key < *keyit)) {
+            return kNoVertex;
+        }
+
+        return static_cast<VertexId>(keyit - m_keys.begin());
+    }
+
+    ///
+    const DataT& GetKey(VertexId vertex) const {
+        return m_keys.at(vertex);
+    }
+
+    ///
+    std::size_t GetNumEdges() const {
+        return m_targets.size();
+    }
+
+    ///
+    std::size_t GetNumVerts() const {
+        return m_keys.size();
+    }
+
+    ///
+    const std::vector<EdgeOffset>& GetInOffsets() const {
+        return m_is_directed ? m_in_offsets : m_offsets;
+    }
+
+    ///
+    const std::vector<VertexId>& GetInSources() const {
+        return m_is_directed ? m_in_sources : m_targets;
+    }
+
+    ///
+    const std::vector<int>& GetInWeights() const {
+        return m_is_directed ? m_in_weights : m_weights;
+    }
+
+    ///
+    LocalityStats GetLocality() const {
+        LocalityStats stats;
+        std::size_t num_near = 0;
+        for (VertexId vert = 0; vert < GetNumVerts(); ++vert) {
+            for (auto edge = m_offsets[vert]; edge < m_offsets[vert + 1]; ++edge) {
+                std::size_t gap = (m_targets[edge] > vert) ? m_targets[edge] - vert
+                                                           : vert - m_targets[edge];
+                stats.average_gap += gap;
+                stats.average_log_gap += std::log2(gap + 1.0);
+                stats.bandwidth = std::max(stats.bandwidth, gap);
+                num_near += (gap < kNearGap) ? 1 : 0;
+            }
+        }
+
+        if (GetNumEdges() != 0) {
+            stats.average_gap /= GetNumEdges();
+            stats.average_log_gap /= GetNumEdges();
+            stats.near_fraction = static_cast<double>(num_near) / GetNumEdges();
+        }
+
+        return stats;
+    }
+
+    ///
+    const std::vector<EdgeOffset>& GetOffsets() const {
+        return m_offsets;
+    }
+
+    ///
+    const std::vector<VertexId>& GetTargets() const {
+        return m_targets;
+    }
+
+    ///
+    const std::vector<DataT>& GetVertexList() const {
+        return m_keys;
+    }
+
+    ///
+    const std::vector<int>& GetWeights() const {
+        return m_weights;
+    }
+
+    ///
+    /// \brief  False for a Reorder copy whose ids no longer follow its keys
+    bool IsKeyOrdered() const {
+        return m_key_order.empty();
+    }
+
+    ///
+    bool IsDirected() const {
+        return m_is_directed;
+    }
+
+    ///
+    /// \brief  Level-synchronous BFS over num_threads workers (0 = all cores). Each level expands
+    ///         top-down from the frontier or, once the frontier's edges outnumber the
+    ///         unexplored ones, bottom-up by having unvisited vertices look for a parent in it.
+    ///         Returns the reached vertices level by level, each level in key order.
+    /// \see    Beamer et al., "Direction-Optimizing Breadth-First Search", SC 2012
+    std::vector<DataT> ParallelBreadthFirstSearch(
+            const DataT& root,
+            ParentList<DataT>* parents = nullptr,
+            unsigned num_threads = 0) const {
+        const std::size_t num_verts = GetNumVerts();
+        std::vector<VertexId> parent(num_verts, kNoVertex);
+        VertexId source = FindId(root);
+        parent.at(source) = source;
+
+        WorkerTeam team(num_threads);
+        AtomicBitmap visited(num_verts);
+        std::vector<std::uint64_t> in_frontier((num_verts + 63) / 64);
+        std::vector<std::vector<VertexId>> next(team.Size());
+        visited.TrySet(source);
+
+        std::vector<VertexId> frontier(1, source);
+        std::vector<DataT> bfs(1, m_keys[source]);
+        const auto& in_offsets = GetInOffsets();
+        const auto& in_sources = GetInSources();
+        auto unexplored_edges = static_cast<std::int64_t>(GetNumEdges());
+        bool bottom_up = false;
+
+        auto expand_top_down = [&](unsigned worker, std::size_t lo, std::size_t hi) {
+            for (auto slot = lo; slot < hi; ++slot) {
+                VertexId src = frontier[slot];
+                for (auto edge = m_offsets[src]; edge < m_offsets[src + 1]; ++edge) {
+                    VertexId vert = m_targets[edge];
+                    if (!visited.Get(vert) && visited.TrySet(vert)) {
+                        parent[vert] = src;
+                        next[worker].push_back(vert);
+                    }
+                }
+            }
+        };
+
+        auto expand_bottom_up = [&](unsigned worker, std::size_t lo, std::size_t hi) {
+            for (auto vert = static_cast<VertexId>(lo); vert < hi; ++vert) {
+                if (visited.Get(vert)) {
+                    continue;
+                }
+
+                for (auto edge = in_offsets[vert]; edge < in_offsets[vert + 1]; ++edge) {
+                    VertexId src = in_sources[edge];
+                    if ((in_frontier[src / 64] >> (src % 64)) & 1) {
+                        parent[vert] = src;
+                        visited.TrySet(vert);
+                        next[worker].push_back(vert);
+                        break;
+                    }
+                }
+            }
+        };
+
+        while (!frontier.empty()) {
+            std::int64_t frontier_edges = 0;
+            for (auto vert : frontier) {
+                frontier_edges += m_offsets[vert + 1] - m_offsets[vert];
+            }
+
+            if (!bottom_up && (frontier_edges > unexplored_edges / kBottomUpAlpha)) {
+                bottom_up = true;
+            } else if (bottom_up && (frontier.size() < num_verts / kTopDownBeta)) {
+                bottom_up = false;
+            }
+
+            unexplored_edges -= frontier_edges;
+            if (bottom_up) {
+                std::fill(in_frontier.begin(), in_frontier.end(), 0);
+                for (auto vert : frontier) {
+                    in_frontier[vert / 64] |= std::uint64_t(1) << (vert % 64);
+                }
+
+                team.ForEach(0, num_verts, expand_bottom_up);
+            } else {
+                team.ForEach(0, frontier.size(), expand_top_down);
+            }
+
+            frontier.clear();
+            for (auto& local : next) {
+                frontier.insert(frontier.end(), local.begin(), local.end());
+                local.clear();
+            }
+
+            std::sort(frontier.begin(), frontier.end());
+            for (auto vert : frontier) {
+                bfs.push_back(m_keys[vert]);
+            }
+        }
+
+        if (parents != nullptr) {
+            parents->clear();
+            for (VertexId vert = 0; vert < num_verts; ++vert) {
+                if ((parent[vert] != kNoVertex) && (vert != source)) {
+                    parents->insert(std::make_pair(m_keys[vert], m_keys[parent[vert]]));
+                }
+            }
+        }
+
+        return bfs;
+    }
+
+    ///
+    /// \brief  Minimum spanning forest of an undirected graph. Equal weights are ordered by
+    ///         their endpoints' keys, so every engine finds the same forest; edges are reported
+    ///         with src before dst in key order, in the order the engine chose them.
+    SpanningTree<DataT> MinimumSpanningTree(
+            SpanningKind kind = SpanningKind::SK_PRIM, unsigned num_threads = 0) const {
+        if (m_is_directed) {
+            throw std::invalid_argument("Minimum spanning trees need an undirected graph");
+        }
+
+        std::vector<UndirectedEdge> chosen;
+        if (kind == SpanningKind::SK_KRUSKAL) {
+            chosen = DoKruskal();
+        } else if (kind == SpanningKind::SK_BORUVKA) {
+            chosen = DoBoruvka(num_threads);
+        } else {
+            chosen = DoPrim();
+        }
+
+        SpanningTree<DataT> tree;
+        tree.edges.reserve(chosen.size());
+        for (const auto& edge : chosen) {
+            tree.edges.push_back(
+                    WeightedEdge<DataT>{m_keys[edge.lo], m_keys[edge.hi], edge.weight});
+            tree.weight += edge.weight;
+        }
+
+        return tree;
+    }
+
+    ///
+    /// \brief  One BFS per root, Width roots at a time: every vertex carries a bitset with a
+    ///         lane per root of the batch, so each adjacency scan advances every search that
+    ///         has reached that vertex at once. Batches are spread over num_threads workers
+    ///         (0 = all cores). Element i lists what roots[i] reaches level by level, each
+    ///         level in key order: the vertices BreadthFirstSearch(roots[i]) visits, at the same
+    ///         hop distances. Width is a multiple of 64; the lane loops vectorize at 256 where
+    ///         the target has AVX2.
+    /// \see    Then et al., "The More the Merrier: Efficient Multi-Source Graph Traversal",
+    ///         VLDB 2014
+    template<std::size_t Width = 256>
+    std::vector<std::vector<DataT>> MultiSourceBreadthFirstSearch(
+            const std::vector<DataT>& roots, unsigned num_threads = 0) const {
+        static_assert((Width > 0) && (Width % 64 == 0), "Roots are batched in whole words");
+        using Lanes = std::array<std::uint64_t, Width / 64>;
+
+        std::vector<VertexId> sources;
+        sources.reserve(roots.size());
+        for (const auto& root : roots) {
+            sources.push_back(FindId(root));
+            if (sources.back() == kNoVertex) {
+                throw std::invalid_argument(
+                        "MultiSourceBreadthFirstSearch root is not in the graph");
+            }
+        }
+
+        /// \struct Scratch
+        /// \brief  Per-worker lanes, all zero between batches
+        struct Scratch {
+            std::vector<Lanes> seen;
+            std::vector<Lanes> visit;
+            std::vector<Lanes> visit_next;
+            std::vector<VertexId> frontier;
+            std::vector<VertexId> candidates;
+            std::vector<VertexId> touched;
+        };
+
+        auto is_empty = [](const Lanes& lanes) {
+            std::uint64_t any = 0;
+            for (auto word : lanes) {
+                any |= word;
+            }
+
+            return any == 0;
+        };
+
+        std::vector<std::vector<DataT>> reached(roots.size());
+        WorkerTeam team(num_threads);
+        std::vector<Scratch> scratch(team.Size());
+        team.ForEach(
+                0,
+                (roots.size() + Width - 1) / Width,
+                [&](unsigned worker, std::size_t lo, std::size_t hi) {
+                    Scratch& mine = scratch[worker];
+                    if (mine.seen.empty()) {
+                        mine.seen.resize(GetNumVerts(), Lanes{});
+                        mine.visit.resize(GetNumVerts(), Lanes{});
+                        mine.visit_next.resize(GetNumVerts(), Lanes{});
+                    }
+
+                    for (auto batch = lo; batch < hi; ++batch) {
+                        std::size_t first = batch * Width;
+                        std::size_t last = std::min(first + Width, sources.size());
+                        DoMultiSourceBatch(mine, is_empty, sources, first, last, reached);
+                    }
+                },
+                1);
+
+        return reached;
+    }
+
+    ///
+    /// \brief  Weakly connected components, numbered like ConnectedComponents by their smallest
+    ///         key; each component lists its vertices in key order rather than search order
+    ComponentList<DataT> ParallelConnectedComponents(
+            ComponentKind kind = ComponentKind::CK_AFFOREST, unsigned num_threads = 0) const {
+        const std::size_t num_verts = GetNumVerts();
+        WorkerTeam team(num_threads);
+        ConcurrentUnionFind sets(num_verts);
+
+        if (kind == ComponentKind::CK_AFFOREST) {
+            DoAfforest(team, sets);
+        } else {
+            team.ForEach(0, num_verts, [&](unsigned, std::size_t lo, std::size_t hi) {
+                for (auto vert = lo; vert < hi; ++vert) {
+                    for (auto edge = m_offsets[vert]; edge < m_offsets[vert + 1]; ++edge) {
+                        sets.Unite(vert, m_targets[edge]);
+                    }
+                }
+            });
+        }
+
+        sets.Flatten();
+
+        auto component_num = 0;
+        ComponentList<DataT> components;
+        std::vector<int> numbers(num_verts, 0);
+        for (VertexId vert = 0; vert < num_verts; ++vert) {
+            VertexId root = sets.GetParent(vert);
+            if (numbers[root] == 0) {
+                numbers[root] = ++component_num;
+            }
+
+            components[numbers[root]].push_back(m_keys[vert]);
+        }
+
+        return components;
+    }
+
+    ///
+    std::vector<DataT> PrimSpanningTree(
+            const DataT& root, ParentList<DataT>* parents = nullptr) const {
+        return DoSpanningSearch(root, parents, [](int, int weight) {
+            return weight;
+        });
+    }
+
+    ///
+    /// \brief  Copy with the vertices renumbered so that arcs join nearby ids, which keeps the
+    ///         per-vertex arrays that traversals and PageRank read along arcs in cache. Keys,
+    ///         weights and each vertex's arc order are kept; only the ids change, and FindId
+    ///         still maps keys to them. GetLocality measures the result.
+    /// \see    Cuthill and McKee, "Reducing the Bandwidth of Sparse Symmetric Matrices", 1969
+    /// \see    Wei et al., "Speedup Graph Processing by Graph Ordering", SIGMOD 2016
+    GraphisCSR Reorder(ReorderKind kind) const {
+        std::vector<VertexId> order;
+        if (kind == ReorderKind::RK_DEGREE) {
+            order = GetIds();
+            std::stable_sort(order.begin(), order.end(), [&](VertexId lhs, VertexId rhs) {
+                return GetDegree(lhs) > GetDegree(rhs);
+            });
+        } else if (kind == ReorderKind::RK_REVERSE_CUTHILL_MCKEE) {
+            order = DoCuthillMcKee();
+            std::reverse(order.begin(), order.end());
+        } else {
+            order = DoGorder();
+        }
+
+        return Permute(order);
+    }
+
+    ///
+    /// \brief  Strongly connected component number of every vertex, in key order. Components
+    ///         are numbered from 0 by their smallest key, so both engines agree; undirected
+    ///         graphs get their connected components. If condensation is given it receives the
+    ///         component DAG, keyed by component number, with one arc per connected pair of
+    ///         components weighted by the cheapest arc between them.
+    std::vector<int> StronglyConnectedComponents(
+            StrongKind kind = StrongKind::SC_TARJAN,
+            GraphisCSR<int>* condensation = nullptr,
+            unsigned num_threads = 0) const {
+        const std::size_t num_verts = GetNumVerts();
+        std::vector<VertexId> leader(num_verts, kNoVertex);
+        if (kind == StrongKind::SC_FORWARD_BACKWARD) {
+            DoForwardBackward(leader, num_threads);
+        } else {
+            DoTarjan(leader);
+        }
+
+        int num_components = 0;
+        std::vector<int> numbers(num_verts, -1);
+        std::vector<int> components(num_verts);
+        for (VertexId vert = 0; vert < num_verts; ++vert) {
+            if (numbers[leader[vert]] < 0) {
+                numbers[leader[vert]] = num_components++;
+            }
+
+            components[vert] = numbers[leader[vert]];
+        }
+
+        if (condensation != nullptr) {
+            *condensation = Condense(components, num_components);
+        }
+
+        return components;
+    }
+
+    ///
+    /// \brief  Kahn's algorithm by wavefronts on num_threads workers (0 = all cores): level 0
+    ///         holds the vertices without in-edges, and each later level the vertices whose
+    ///         last in-neighbor sat in the level before, so the vertices of one level never
+    ///         depend on each other. Each level is in key order. Vertices on or behind a cycle
+    ///         never reach in-degree zero; then one cycle goes to cycle, in edge order, and the
+    ///         levels of the rest are returned, or std::runtime_error is thrown if cycle is null.
+    std::vector<std::vector<DataT>> TopologicalLevels(
+            std::vector<DataT>* cycle = nullptr, unsigned num_threads = 0) const {
+        if (!m_is_directed) {
+            throw std::invalid_argument("Topological levels need a directed graph");
+        }
+
+        const std::size_t num_verts = GetNumVerts();
+        WorkerTeam team(num_threads);
+        std::vector<std::atomic<EdgeOffset>> in_degrees(num_verts);
+        std::vector<std::vector<VertexId>> next(team.Size());
+        team.ForEach(0, num_verts, [&](unsigned worker, std::size_t lo, std::size_t hi) {
+            for (auto vert = static_cast<VertexId>(lo); vert < hi; ++vert) {
+                in_degrees[vert].store(m_in_offsets[vert + 1] - m_in_offsets[vert]);
+                if (m_in_offsets[vert + 1] == m_in_offsets[vert]) {
+                    next[worker].push_back(vert);
+                }
+            }
+        });
+
+        std::size_t num_sorted = 0;
+        std::vector<VertexId> frontier;
+        std::vector<std::vector<DataT>> levels;
+        auto gather = [&]() {
+            frontier.clear();
+            for (auto& local : next) {
+                frontier.insert(frontier.end(), local.begin(), local.end());
+                local.clear();
+            }
+
+            std::sort(frontier.begin(), frontier.end());
+            num_sorted += frontier.size();
+        };
+
+        for (gather(); !frontier.empty(); gather()) {
+            levels.emplace_back();
+            levels.back().reserve(frontier.size());
+            for (auto vert : frontier) {
+                levels.back().push_back(m_keys[vert]);
+            }
+
+            team.ForEach(0, frontier.size(), [&](unsigned worker, std::size_t lo, std::size_t hi) {
+                for (auto slot = lo; slot < hi; ++slot) {
+                    VertexId vert = frontier[slot];
+                    for (auto edge = m_offsets[vert]; edge < m_offsets[vert + 1]; ++edge) {
+                        if (in_degrees[m_targets[edge]].fetch_sub(1) == 1) {
+                            next[worker].push_back(m_targets[edge]);
+                        }
+                    }
+                }
+            });
+        }
+
+        if (num_sorted == num_verts) {
+            if (cycle != nullptr) {
+                cycle->clear();
+            }
+
+            return levels;
+        }
+
+        if (cycle == nullptr) {
+            throw std::runtime_error("Topological levels of a graph with a cycle");
+        }
+
+        // Every unsorted vertex still has an unsorted in-neighbor, so walking backwards
+        // through them must revisit one; the walk from there on is the cycle, reversed
+        VertexId vert = 0;
+        while (in_degrees[vert].load() == 0) {
+            ++vert;
+        }
+
+        std::vector<VertexId> steps(num_verts, kNoVertex);
+        while (steps[vert] == kNoVertex) {
+            for (auto edge = m_in_offsets[vert]; edge < m_in_offsets[vert + 1]; ++edge) {
+                if (in_degrees[m_in_sources[edge]].load() != 0) {
+                    steps[vert] = m_in_sources[edge];
+                    break;
+                }
+            }
+
+            vert = steps[vert];
+        }
+
+        cycle->clear();
+        VertexId start = vert;
+        do {
+            cycle->push_back(m_keys[vert]);
+            vert = steps[vert];
+        } while (vert != start);
+
+        std::reverse(cycle->begin(), cycle->end());
+        return levels;
+    }
+
+    ///
+    /// \brief  Reverse DFS finishing order, rooted at each undiscovered vertex in key order
+    std::vector<DataT> TopologicalSort() const {
+        std::vector<DataT> sorted;
+        std::vector<bool> discovered(GetNumVerts(), false);
+        for (VertexId vert = 0; vert < GetNumVerts(); ++vert) {
+            if (!discovered[vert]) {
+                DoDepthFirstSearch(
+                        vert,
+                        discovered,
+                        [](VertexId) {},
+                        [&](VertexId done) { sorted.push_back(m_keys[done]); });
+            }
+        }
+
+        std::reverse(sorted.begin(), sorted.end());
+        return sorted;
+    }
+
+private:
+    template<typename>
+    friend class GraphisCSR;
+
+    /// Direction-switch thresholds from Beamer et al.
+    static constexpr std::int64_t kBottomUpAlpha = 14;
+    static constexpr std::size_t kTopDownBeta = 24;
+
+    /// Floyd-Warshall tile edge, and the "no path yet" value that two of can be added safely
+    static constexpr std::size_t kFloydTile = 64;
+    static constexpr int kFloydInfinity = std::numeric_limits<int>::max() / 2;
+
+    /// Afforest sampling sizes from Sutton et al.
+    static constexpr EdgeOffset kSampledNeighbors = 2;
+    static constexpr std::size_t kComponentSamples = 1024;
+
+    /// Forward-backward subproblems this large search level by level across the team; smaller
+    /// ones are left whole to a single worker, and the color that marks finished vertices
+    static constexpr std::size_t kParallelSplitSize = 4096;
+    static constexpr std::uint32_t kSettledColor = std::numeric_limits<std::uint32_t>::max();
+
+    /// Ids closer than this share a cache line of a per-vertex double array, and Gorder's
+    /// window size from Wei et al.
+    static constexpr std::size_t kNearGap = 8;
+    static constexpr std::size_t kGorderWindow = 5;
+
+    /// \struct UndirectedEdge
+    /// \brief  One undirected edge, lo < hi, ordered by weight and then by endpoints
+    struct UndirectedEdge {
+        ///
+        bool operator<(const UndirectedEdge& rhs) const {
+            return std::tie(weight, lo, hi) < std::tie(rhs.weight, rhs.lo, rhs.hi);
+        }
+
+        int weight;
+        VertexId lo;
+        VertexId hi;
+    };
+
+    ///
+    /// \brief  Counting-sorts the out-edges by target into the transposed arrays; each
+    ///         vertex's in-edges are listed in source order
+    void BuildInEdges() {
+        if (!m_is_directed) {
+            return;
+        }
+
+        m_in_offsets.assign(GetNumVerts() + 1, 0);
+        for (auto target : m_targets) {
+            ++m_in_offsets[target + 1];
+        }
+
+        for (std::size_t vert = 0; vert < GetNumVerts(); ++vert) {
+            m_in_offsets[vert + 1] += m_in_offsets[vert];
+        }
+
+        std::vector<EdgeOffset> cursor(m_in_offsets.begin(), m_in_offsets.end() - 1);
+        m_in_sources.resize(GetNumEdges());
+        m_in_weights.resize(GetNumEdges());
+        for (VertexId vert = 0; vert < GetNumVerts(); ++vert) {
+            for (auto edge = m_offsets[vert]; edge < m_offsets[vert + 1]; ++edge) {
+                auto slot = cursor[m_targets[edge]]++;
+                m_in_sources[slot] = vert;
+                m_in_weights[slot] = m_weights[edge];
+            }
+        }
+    }
+
+    ///
+    /// \brief  Component DAG for StronglyConnectedComponents
+    GraphisCSR<int> Condense(const std::vector<int>& components, int num_components) const {
+        std::vector<std::tuple<int, int, int>> arcs;
+        for (VertexId vert = 0; vert < GetNumVerts(); ++vert) {
+            for (auto edge = m_offsets[vert]; edge < m_offsets[vert + 1]; ++edge) {
+                int target = components[m_targets[edge]];
+                if (target != components[vert]) {
+                    arcs.emplace_back(components[vert], target, m_weights[edge]);
+                }
+            }
+        }
+
+        // Sorted, the cheapest of a run of parallel arcs comes first
+        std::sort(arcs.begin(), arcs.end());
+
+        GraphisCSR<int> dag;
+        dag.m_is_directed = true;
+        dag.m_keys.resize(num_components);
+        dag.m_offsets.assign(num_components + 1, 0);
+        for (int component = 0; component < num_components; ++component) {
+            dag.m_keys[component] = component;
+        }
+
+        for (std::size_t slot = 0; slot < arcs.size(); ++slot) {
+            int src = std::get<0>(arcs[slot]);
+            int dst = std::get<1>(arcs[slot]);
+            if ((slot > 0) && (src == std::get<0>(arcs[slot - 1]))
+                && (dst == std::get<1>(arcs[slot - 1]))) {
+                continue;
+            }
+
+            dag.m_targets.push_back(dst);
+            dag.m_weights.push_back(std::get<2>(arcs[slot]));
+            ++dag.m_offsets[src + 1];
+        }
+
+        for (int component = 0; component < num_components; ++component) {
+            dag.m_offsets[component + 1] += dag.m_offsets[component];
+        }
+
+        dag.BuildInEdges();
+        return dag;
+    }
+
+    ///
+    /// \brief  Cuthill-McKee over arcs in both directions: each component is searched from
+    ///         its lowest-degree vertex, and each vertex's new neighbors are queued by degree
+    std::vector<VertexId> DoCuthillMcKee() const {
+        const auto& in_offsets = GetInOffsets();
+        const auto& in_sources = GetInSources();
+        std::vector<VertexId> order;
+        order.reserve(GetNumVerts());
+        std::vector<bool> discovered(GetNumVerts(), false);
+        auto by_degree = [&](VertexId lhs, VertexId rhs) {
+            return std::make_pair(GetDegree(lhs), lhs) < std::make_pair(GetDegree(rhs), rhs);
+        };
+
+        std::vector<VertexId> by_rising_degree = GetIds();
+        std::sort(by_rising_degree.begin(), by_rising_degree.end(), by_degree);
+        for (auto start : by_rising_degree) {
+            if (discovered[start]) {
+                continue;
+            }
+
+            discovered[start] = true;
+            order.push_back(start);
+            for (std::size_t next = order.size() - 1; next < order.size(); ++next) {
+                VertexId vert = order[next];
+                std::size_t first_new = order.size();
+                auto discover = [&](VertexId neighbor) {
+                    if (!discovered[neighbor]) {
+                        discovered[neighbor] = true;
+                        order.push_back(neighbor);
+                    }
+                };
+
+                for (auto edge = m_offsets[vert]; edge < m_offsets[vert + 1]; ++edge) {
+                    discover(m_targets[edge]);
+                }
+
+                for (auto edge = in_offsets[vert]; edge < in_offsets[vert + 1]; ++edge) {
+                    discover(in_sources[edge]);
+                }
+
+                std::sort(order.begin() + first_new, order.end(), by_degree);
+            }
+        }
+
+        return order;
+    }
+
+    ///
+    /// \brief  Gorder: repeatedly places the unplaced vertex with the highest score against
+    ///         the last kGorderWindow placed, scoring one per arc between them and one per
+    ///         in-neighbor they share. Shared in-neighbors with more than sqrt(n) out-arcs are
+    ///         skipped, as in the paper, since they say little and cost the most.
+    std::vector<VertexId> DoGorder() const {
+        const std::size_t num_verts = GetNumVerts();
+        const auto& in_offsets = GetInOffsets();
+        const auto& in_sources = GetInSources();
+        const auto hub_degree = static_cast<EdgeOffset>(std::sqrt(num_verts)) + 1;
+
+        // A min-heap of negated scores; equal scores pop in id order
+        IndexedHeap<std::int64_t> kew(num_verts);
+        VertexId start = 0;
+        EdgeOffset start_degree = 0;
+        for (VertexId vert = 0; vert < num_verts; ++vert) {
+            kew.Push(vert, 0);
+            if (in_offsets[vert + 1] - in_offsets[vert] > start_degree) {
+                start = vert;
+                start_degree = in_offsets[vert + 1] - in_offsets[vert];
+            }
+        }
+
+        auto adjust = [&](VertexId vert, std::int64_t delta) {
+            if (kew.Contains(vert)) {
+                kew.Update(vert, kew.GetKey(vert) - delta);
+            }
+        };
+
+        // Scores every unplaced vertex against placed entering (+1) or leaving (-1) the window
+        auto shift = [&](VertexId placed, std::int64_t delta) {
+            for (auto edge = m_offsets[placed]; edge < m_offsets[placed + 1]; ++edge) {
+                adjust(m_targets[edge], delta);
+            }
+
+            for (auto edge = in_offsets[placed]; edge < in_offsets[placed + 1]; ++edge) {
+                VertexId parent = in_sources[edge];
+                adjust(parent, delta);
+                if (m_offsets[parent + 1] - m_offsets[parent] <= hub_degree) {
+                    for (auto sibling = m_offsets[parent]; sibling < m_offsets[parent + 1];
+                         ++sibling) {
+                        adjust(m_targets[sibling], delta);
+                    }
+                }
+            }
+        };
+
+        std::vector<VertexId> order;
+        order.reserve(num_verts);
+        if (num_verts != 0) {
+            kew.Update(start, std::numeric_limits<std::int64_t>::min());
+        }
+
+        while (!kew.IsEmpty()) {
+            order.push_back(kew.PopMin());
+            shift(order.back(), 1);
+            if (order.size() > kGorderWindow) {
+                shift(order[order.size() - kGorderWindow - 1], -1);
+            }
+        }
+
+        return order;
+    }
+
+    ///
+    void DoBreadthFirstSearch(
+            VertexId root, std::vector<bool>& discovered, std::vector<DataT>& bfs) const {
+        std::queue<VertexId> kew;
+        discovered.at(root) = true;
+        kew.push(root);
+
+        while (!kew.empty()) {
+            VertexId current = kew.front();
+            kew.pop();
+            bfs.push_back(m_keys[current]);
+
+            for (auto edge = m_offsets[current]; edge < m_offsets[current + 1]; ++edge) {
+                VertexId vert = m_targets[edge];
+                if (!discovered[vert]) {
+                    discovered[vert] = true;
+                    kew.push(vert);
+                }
+            }
+        }
+    }
+
+    ///
+    /// \brief  Afforest: link the first few edges of every vertex, guess the largest component
+    ///         from a sample of vertices, then link the remaining edges only of vertices outside
+    ///         it. An edge leaving the skipped component is still linked from its other end,
+    ///         which for a directed graph means walking the in-edges as well.
+    void DoAfforest(WorkerTeam& team, ConcurrentUnionFind& sets) const {
+        const std::size_t num_verts = GetNumVerts();
+        for (EdgeOffset round = 0; round < kSampledNeighbors; ++round) {
+            team.ForEach(0, num_verts, [&](unsigned, std::size_t lo, std::size_t hi) {
+                for (auto vert = lo; vert < hi; ++vert) {
+                    if (m_offsets[vert] + round < m_offsets[vert + 1]) {
+                        sets.Unite(vert, m_targets[m_offsets[vert] + round]);
+                    }
+                }
+            });
+        }
+
+        if (num_verts == 0) {
+            return;
+        }
+
+        std::mt19937 rng(static_cast<std::mt19937::result_type>(num_verts));
+        std::uniform_int_distribution<std::size_t> any(0, num_verts - 1);
+        std::map<VertexId, int> counts;
+        for (std::size_t sample = 0; sample < kComponentSamples; ++sample) {
+            ++counts[sets.Find(any(rng))];
+        }
+
+        VertexId largest = counts.begin()->first;
+        for (const auto& count : counts) {
+            if (count.second > counts[largest]) {
+                largest = count.first;
+            }
+        }
+
+        const auto& in_offsets = GetInOffsets();
+        const auto& in_sources = GetInSources();
+        team.ForEach(0, num_verts, [&](unsigned, std::size_t lo, std::size_t hi) {
+            for (auto vert = lo; vert < hi; ++vert) {
+                if (sets.Find(vert) == largest) {
+                    continue;
+                }
+
+                auto first = std::min(m_offsets[vert] + kSampledNeighbors, m_offsets[vert + 1]);
+                for (auto edge = first; edge < m_offsets[vert + 1]; ++edge) {
+                    sets.Unite(vert, m_targets[edge]);
+                }
+
+                if (m_is_directed) {
+                    for (auto edge = in_offsets[vert]; edge < in_offsets[vert + 1]; ++edge) {
+                        sets.Unite(vert, in_sources[edge]);
+                    }
+                }
+            }
+        });
+    }
+
+    ///
+    /// \brief  Rounds of: every component picks its cheapest outgoing edge in parallel, then the
+    ///         picks are linked. Ties are broken by edge order, so the picks cannot form a cycle.
+    std::vector<UndirectedEdge> DoBoruvka(unsigned num_threads) const {
+        const std::size_t num_verts = GetNumVerts();
+        constexpr std::uint64_t kNoEdge = std::numeric_limits<std::uint64_t>::max();
+
+        std::vector<UndirectedEdge> edges = GetUndirectedEdges();
+        WorkerTeam team(num_threads);
+        ConcurrentUnionFind sets(num_verts);
+        std::vector<VertexId> roots(num_verts);
+        std::vector<std::atomic<std::uint64_t>> cheapest(num_verts);
+        std::vector<std::vector<UndirectedEdge>> linked(team.Size());
+
+        auto lighter = [&](std::uint64_t lhs, std::uint64_t rhs) {
+            return (rhs == kNoEdge) || (edges[lhs] < edges[rhs])
+                   || (!(edges[rhs] < edges[lhs]) && (lhs < rhs));
+        };
+
+        auto offer = [&](VertexId root, std::uint64_t edge) {
+            std::uint64_t current = cheapest[root].load(std::memory_order_relaxed);
+            while (lighter(edge, current)
+                   && !cheapest[root].compare_exchange_weak(current, edge)) {
+            }
+        };
+
+        std::vector<UndirectedEdge> chosen;
+        for (;;) {
+            team.ForEach(0, num_verts, [&](unsigned, std::size_t lo, std::size_t hi) {
+                for (auto vert = lo; vert < hi; ++vert) {
+                    roots[vert] = sets.Find(vert);
+                    cheapest[vert].store(kNoEdge, std::memory_order_relaxed);
+                }
+            });
+
+            team.ForEach(0, edges.size(), [&](unsigned, std::size_t lo, std::size_t hi) {
+                for (auto edge = lo; edge < hi; ++edge) {
+                    VertexId lo_root = roots[edges[edge].lo];
+                    VertexId hi_root = roots[edges[edge].hi];
+                    if (lo_root != hi_root) {
+                        offer(lo_root, edge);
+                        offer(hi_root, edge);
+                    }
+                }
+            });
+
+            team.ForEach(0, num_verts, [&](unsigned worker, std::size_t lo, std::size_t hi) {
+                for (auto vert = lo; vert < hi; ++vert) {
+                    std::uint64_t edge = cheapest[vert].load(std::memory_order_relaxed);
+                    if ((edge != kNoEdge) && sets.Unite(edges[edge].lo, edges[edge].hi)) {
+                        linked[worker].push_back(edges[edge]);
+                    }
+                }
+            });
+
+            std::size_t num_chosen = chosen.size();
+            for (auto& local : linked) {
+                chosen.insert(chosen.end(), local.begin(), local.end());
+                local.clear();
+            }
+
+            if (chosen.size() == num_chosen) {
+                return chosen;
+            }
+        }
+    }
+
+    ///
+    /// \brief  Floyd-Warshall over kFloydTile-square tiles of a padded matrix. Each round closes
+    ///         the diagonal tile, then the tiles in its row and column, then all the others,
+    ///         which only read those; every tile update is a branch-free min over whole rows.
+    /// \see    Venkataraman et al., "A Blocked All-Pairs Shortest-Paths Algorithm", JEA 2003
+    DistanceMatrix DoFloydWarshall(WorkerTeam& team) const {
+        const std::size_t num_verts = GetNumVerts();
+        const std::size_t num_tiles = (num_verts + kFloydTile - 1) / kFloydTile;
+        const std::size_t stride = num_tiles * kFloydTile;
+        std::vector<int> padded(stride * stride, kFloydInfinity);
+        for (std::size_t src = 0; src < num_verts; ++src) {
+            padded[src * stride + src] = 0;
+            for (auto edge = m_offsets[src]; edge < m_offsets[src + 1]; ++edge) {
+                int& cell = padded[src * stride + m_targets[edge]];
+                cell = std::min(cell, m_weights[edge]);
+            }
+        }
+
+        auto tile = [&](std::size_t row, std::size_t col) {
+            return padded.data() + (row * stride + col) * kFloydTile;
+        };
+
+        for (std::size_t round = 0; round < num_tiles; ++round) {
+            int* pivot = tile(round, round);
+            RelaxTile(pivot, pivot, pivot, stride);
+            team.ForEach(
+                    0,
+                    num_tiles,
+                    [&](unsigned, std::size_t lo, std::size_t hi) {
+                        for (auto other = lo; other < hi; ++other) {
+                            if (other != round) {
+                                RelaxTile(tile(round, other), pivot, tile(round, other), stride);
+                                RelaxTile(tile(other, round), tile(other, round), pivot, stride);
+                            }
+                        }
+                    },
+                    1);
+            team.ForEach(
+                    0,
+                    num_tiles,
+                    [&](unsigned, std::size_t lo, std::size_t hi) {
+                        for (auto row = lo; row < hi; ++row) {
+                            for (std::size_t col = 0; (row != round) && (col < num_tiles); ++col) {
+                                if (col != round) {
+                                    RelaxTile(tile(row, col), tile(row, round), tile(round, col),
+                                              stride);
+                                }
+                            }
+                        }
+                    },
+                    1);
+        }
+
+        DistanceMatrix distances(num_verts);
+        int* out = distances.GetData();
+        for (std::size_t src = 0; src < num_verts; ++src) {
+            if (padded[src * stride + src] < 0) {
+                throw std::runtime_error("Negative cycle in all-pairs shortest paths");
+            }
+
+            for (std::size_t dst = 0; dst < num_verts; ++dst) {
+                int distance = padded[src * stride + dst];
+                out[src * num_verts + dst] = (distance > kFloydInfinity / 2) ? kUnreachable
+                                                                             : distance;
+            }
+        }
+
+        return distances;
+    }
+
+    ///
+    /// \brief  Trims vertices without live in- or out-edges, which are components by
+    ///         themselves, then splits what is left by forward-backward search: the vertices
+    ///         both reachable from a pivot and reaching it are its component, and the rest falls
+    ///         into three subproblems that no component straddles. A vertex's color names its
+    ///         subproblem, so searches confined to one never collide with another's.
+    /// \see    Hong et al., "On Fast Parallel Detection of Strongly Connected Components (SCC)
+    ///         in Small-World Graphs", SC 2013
+    void DoForwardBackward(std::vector<VertexId>& leader, unsigned num_threads) const {
+        const std::size_t num_verts = GetNumVerts();
+        const auto& in_offsets = GetInOffsets();
+        const auto& in_sources = GetInSources();
+        WorkerTeam team(num_threads);
+        std::vector<std::atomic<std::uint32_t>> colors(num_verts);
+        std::vector<std::atomic<EdgeOffset>> out_live(num_verts);
+        std::vector<std::atomic<EdgeOffset>> in_live(num_verts);
+        std::vector<std::vector<VertexId>> trimmed(team.Size());
+
+        std::vector<VertexId> frontier;
+        auto gather = [&]() {
+            frontier.clear();
+            for (auto& local : trimmed) {
+                frontier.insert(frontier.end(), local.begin(), local.end());
+                local.clear();
+            }
+        };
+
+        // Self-loops are left out of the live counts, since they never join two vertices
+        team.ForEach(0, num_verts, [&](unsigned worker, std::size_t lo, std::size_t hi) {
+            for (auto vert = static_cast<VertexId>(lo); vert < hi; ++vert) {
+                EdgeOffset outs = 0;
+                EdgeOffset ins = 0;
+                for (auto edge = m_offsets[vert]; edge < m_offsets[vert + 1]; ++edge) {
+                    outs += (m_targets[edge] != vert) ? 1 : 0;
+                }
+
+                for (auto edge = in_offsets[vert]; edge < in_offsets[vert + 1]; ++edge) {
+                    ins += (in_sources[edge] != vert) ? 1 : 0;
+                }
+
+                colors[vert].store(0);
+                out_live[vert].store(outs);
+                in_live[vert].store(ins);
+                if ((outs == 0) || (ins == 0)) {
+                    colors[vert].store(kSettledColor);
+                    leader[vert] = vert;
+                    trimmed[worker].push_back(vert);
+                }
+            }
+        });
+
+        for (gather(); !frontier.empty(); gather()) {
+            team.ForEach(0, frontier.size(), [&](unsigned worker, std::size_t lo, std::size_t hi) {
+                auto trim = [&](VertexId vert, std::atomic<EdgeOffset>& live) {
+                    std::uint32_t unsettled = 0;
+                    if ((live.fetch_sub(1) == 1)
+                        && colors[vert].compare_exchange_strong(unsettled, kSettledColor)) {
+                        leader[vert] = vert;
+                        trimmed[worker].push_back(vert);
+                    }
+                };
+
+                for (auto slot = lo; slot < hi; ++slot) {
+                    VertexId vert = frontier[slot];
+                    for (auto edge = m_offsets[vert]; edge < m_offsets[vert + 1]; ++edge) {
+                        if (m_targets[edge] != vert) {
+                            trim(m_targets[edge], in_live[m_targets[edge]]);
+                        }
+                    }
+
+                    for (auto edge = in_offsets[vert]; edge < in_offsets[vert + 1]; ++edge) {
+                        if (in_sources[edge] != vert) {
+                            trim(in_sources[edge], out_live[in_sources[edge]]);
+                        }
+                    }
+                }
+            });
+        }
+
+        std::atomic<std::uint32_t> next_color(1);
+        auto split = [&](const std::vector<VertexId>& part,
+                         WorkerTeam* searchers,
+                         std::vector<std::vector<VertexId>>& parts) {
+            const VertexId pivot = part.front();
+            const std::uint32_t color = colors[pivot].load();
+            const std::uint32_t forward = next_color.fetch_add(2);
+            const std::uint32_t backward = forward + 1;
+            colors[pivot].store(forward);
+            DoReach(searchers, pivot, m_offsets, m_targets, [&](VertexId vert) {
+                std::uint32_t expected = color;
+                return colors[vert].compare_exchange_strong(expected, forward);
+            });
+
+            colors[pivot].store(kSettledColor);
+            leader[pivot] = pivot;
+            DoReach(searchers, pivot, in_offsets, in_sources, [&](VertexId vert) {
+                std::uint32_t expected = forward;
+                if (colors[vert].compare_exchange_strong(expected, kSettledColor)) {
+                    leader[vert] = pivot;
+                    return true;
+                }
+
+                expected = color;
+                return colors[vert].compare_exchange_strong(expected, backward);
+            });
+
+            std::vector<VertexId> forward_only;
+            std::vector<VertexId> backward_only;
+            std::vector<VertexId> rest;
+            for (auto vert : part) {
+                std::uint32_t now = colors[vert].load();
+                if (now == forward) {
+                    forward_only.push_back(vert);
+                } else if (now == backward) {
+                    backward_only.push_back(vert);
+                } else if (now == color) {
+                    rest.push_back(vert);
+                }
+            }
+
+            for (auto* next : {&forward_only, &backward_only, &rest}) {
+                if (!next->empty()) {
+                    parts.push_back(std::move(*next));
+                }
+            }
+        };
+
+        std::vector<std::vector<VertexId>> pending(1);
+        for (VertexId vert = 0; vert < num_verts; ++vert) {
+            if (colors[vert].load() == 0) {
+                pending.front().push_back(vert);
+            }
+        }
+
+        if (pending.front().empty()) {
+            return;
+        }
+
+        while (!pending.empty()) {
+            std::vector<std::vector<VertexId>> small;
+            std::vector<std::vector<VertexId>> large;
+            for (auto& part : pending) {
+                (part.size() >= kParallelSplitSize ? large : small).push_back(std::move(part));
+            }
+
+            pending.clear();
+            for (const auto& part : large) {
+                split(part, &team, pending);
+            }
+
+            team.ForEach(
+                    0,
+                    small.size(),
+                    [&](unsigned, std::size_t lo, std::size_t hi) {
+                        std::vector<std::vector<VertexId>> local(
+                                std::make_move_iterator(small.begin() + lo),
+                                std::make_move_iterator(small.begin() + hi));
+                        while (!local.empty()) {
+                            std::vector<VertexId> part = std::move(local.back());
+                            local.pop_back();
+                            split(part, nullptr, local);
+                        }
+                    },
+                    1);
+        }
+    }
+
+    ///
+    /// \brief  Bellman-Ford potentials make every weight non-negative without changing which
+    ///         paths are shortest, then each worker runs Dijkstra from its share of the sources,
+    ///         using the source's matrix row as its distance array.
+    /// \see    Johnson, "Efficient Algorithms for Shortest Paths in Sparse Networks", JACM 1977
+    DistanceMatrix DoJohnson(WorkerTeam& team) const {
+        const std::size_t num_verts = GetNumVerts();
+        std::vector<int> potential = GetPotentials();
+        DistanceMatrix distances(num_verts);
+        std::vector<IndexedHeap<int>> kews(team.Size(), IndexedHeap<int>(num_verts));
+
+        team.ForEach(
+                0,
+                num_verts,
+                [&](unsigned worker, std::size_t lo, std::size_t hi) {
+                    IndexedHeap<int>& kew = kews[worker];
+                    for (auto src = lo; src < hi; ++src) {
+                        int* row = distances.GetData() + src * num_verts;
+                        row[src] = 0;
+                        kew.Push(src, 0);
+                        while (!kew.IsEmpty()) {
+                            VertexId current = kew.PopMin();
+                            int base = row[current] + potential[current];
+                            for (auto edge = m_offsets[current]; edge < m_offsets[current + 1];
+                                 ++edge) {
+                                VertexId dst = m_targets[edge];
+                                int distance = base + m_weights[edge] - potential[dst];
+                                if (distance < row[dst]) {
+                                    row[dst] = distance;
+                                    kew.Push(dst, distance);
+                                }
+                            }
+                        }
+
+                        for (std::size_t dst = 0; dst < num_verts; ++dst) {
+                            if (row[dst] != kUnreachable) {
+                                row[dst] += potential[dst] - potential[src];
+                            }
+                        }
+                    }
+                },
+                1);
+
+        return distances;
+    }
+
+    ///
+    /// \brief  Sorts the edges once and links them in order, skipping any that close a cycle
+    std::vector<UndirectedEdge> DoKruskal() const {
+        std::vector<UndirectedEdge> edges = GetUndirectedEdges();
+        std::sort(edges.begin(), edges.end());
+
+        ConcurrentUnionFind sets(GetNumVerts());
+        std::vector<UndirectedEdge> chosen;
+        for (const auto& edge : edges) {
+            if (sets.Unite(edge.lo, edge.hi)) {
+                chosen.push_back(edge);
+            }
+        }
+
+        return chosen;
+    }
+
+    ///
+    /// \brief  Heap-based Prim grown from each unspanned vertex in key order; the heap is keyed
+    ///         on the whole edge so ties resolve as in Kruskal
+    std::vector<UndirectedEdge> DoPrim() const {
+        using EdgeKey = std::tuple<int, VertexId, VertexId>;
+
+        std::vector<bool> in_span(GetNumVerts(), false);
+        IndexedHeap<EdgeKey> kew(GetNumVerts());
+        std::vector<UndirectedEdge> chosen;
+
+        for (VertexId root = 0; root < GetNumVerts(); ++root) {
+            if (in_span[root]) {
+                continue;
+            }
+
+            kew.Push(root, EdgeKey(std::numeric_limits<int>::min(), root, root));
+            while (!kew.IsEmpty()) {
+                VertexId current = kew.PopMin();
+                in_span[current] = true;
+                if (current != root) {
+                    const EdgeKey& key = kew.GetKey(current);
+                    chosen.push_back(
+                            UndirectedEdge{std::get<0>(key), std::get<1>(key), std::get<2>(key)});
+                }
+
+                for (auto edge = m_offsets[current]; edge < m_offsets[current + 1]; ++edge) {
+                    VertexId candidate = m_targets[edge];
+                    if (!in_span[candidate]) {
+                        kew.Push(
+                                candidate,
+                                EdgeKey(m_weights[edge],
+                                        std::min(current, candidate),
+                                        std::max(current, candidate)));
+                    }
+                }
+            }
+        }
+
+        return chosen;
+    }
+
+    ///
+    /// \brief  Iterative DFS; enter fires in preorder, leave fires in finishing order
+    template<typename EnterFn, typename LeaveFn>
+    void DoDepthFirstSearch(
+            VertexId root,
+            std::vector<bool>& discovered,
+            EnterFn enter,
+            LeaveFn leave) const {
+        std::stack<std::pair<VertexId, EdgeOffset>> pending;
+        discovered.at(root) = true;
+        enter(root);
+        pending.push(std::make_pair(root, m_offsets[root]));
+
+        while (!pending.empty()) {
+            auto& top = pending.top();
+            if (top.second == m_offsets[top.first + 1]) {
+                leave(top.first);
+                pending.pop();
+                continue;
+            }
+
+            VertexId vert = m_targets[top.second++];
+            if (!discovered[vert]) {
+                discovered[vert] = true;
+                enter(vert);
+                pending.push(std::make_pair(vert, m_offsets[vert]));
+            }
+        }
+    }
+
+    ///
+    /// \brief  One MultiSourceBreadthFirstSearch batch, roots sources[first, last); leaves the
+    ///         scratch lanes zeroed again
+    template<typename ScratchT, typename EmptyFn>
+    void DoMultiSourceBatch(
+            ScratchT& mine,
+            EmptyFn is_empty,
+            const std::vector<VertexId>& sources,
+            std::size_t first,
+            std::size_t last,
+            std::vector<std::vector<DataT>>& reached) const {
+        auto& seen = mine.seen;
+        auto& visit = mine.visit;
+        auto& visit_next = mine.visit_next;
+        const std::size_t num_words = seen.front().size();
+
+        mine.frontier.clear();
+        for (auto slot = first; slot < last; ++slot) {
+            VertexId root = sources[slot];
+            if (is_empty(visit[root])) {
+                mine.frontier.push_back(root);
+            }
+
+            auto lane = slot - first;
+            seen[root][lane / 64] |= std::uint64_t(1) << (lane % 64);
+            visit[root][lane / 64] |= std::uint64_t(1) << (lane % 64);
+            reached[slot].push_back(m_keys[root]);
+        }
+
+        mine.touched = mine.frontier;
+        while (!mine.frontier.empty()) {
+            mine.candidates.clear();
+            for (auto vert : mine.frontier) {
+                for (auto edge = m_offsets[vert]; edge < m_offsets[vert + 1]; ++edge) {
+                    auto& next = visit_next[m_targets[edge]];
+                    if (is_empty(next)) {
+                        mine.candidates.push_back(m_targets[edge]);
+                    }
+
+                    for (std::size_t word = 0; word < num_words; ++word) {
+                        next[word] |= visit[vert][word];
+                    }
+                }
+
+                visit[vert].fill(0);
+            }
+
+            // Sorted candidates put every root's level in key order
+            std::sort(mine.candidates.begin(), mine.candidates.end());
+            mine.frontier.clear();
+            for (auto vert : mine.candidates) {
+                bool fresh = false;
+                bool untouched = is_empty(seen[vert]);
+                for (std::size_t word = 0; word < num_words; ++word) {
+                    std::uint64_t newly = visit_next[vert][word] & ~seen[vert][word];
+                    seen[vert][word] |= newly;
+                    visit[vert][word] = newly;
+                    fresh = fresh || (newly != 0);
+                    for (std::size_t lane = word * 64; newly != 0; ++lane, newly >>= 1) {
+                        if (newly & 1) {
+                            reached[first + lane].push_back(m_keys[vert]);
+                        }
+                    }
+                }
+
+                visit_next[vert].fill(0);
+                if (fresh) {
+                    mine.frontier.push_back(vert);
+                    if (untouched) {
+                        mine.touched.push_back(vert);
+                    }
+                }
+            }
+        }
+
+        for (auto vert : mine.touched) {
+            seen[vert].fill(0);
+        }
+    }
+
+    ///
+    /// \brief  Everything reachable from root along [offsets, targets] that claim(vertex)
+    ///         accepts; claim must succeed at most once per vertex. Level-synchronous across
+    ///         the team if one is given, otherwise a serial stack walk.
+    template<typename ClaimFn>
+    void DoReach(
+            WorkerTeam* team,
+            VertexId root,
+            const std::vector<EdgeOffset>& offsets,
+            const std::vector<VertexId>& targets,
+            ClaimFn claim) const {
+        std::vector<VertexId> frontier(1, root);
+        if (team == nullptr) {
+            while (!frontier.empty()) {
+                VertexId vert = frontier.back();
+                frontier.pop_back();
+                for (auto edge = offsets[vert]; edge < offsets[vert + 1]; ++edge) {
+                    if (claim(targets[edge])) {
+                        frontier.push_back(targets[edge]);
+                    }
+                }
+            }
+
+            return;
+        }
+
+        std::vector<std::vector<VertexId>> next(team->Size());
+        while (!frontier.empty()) {
+            team->ForEach(0, frontier.size(), [&](unsigned worker, std::size_t lo, std::size_t hi) {
+                for (auto slot = lo; slot < hi; ++slot) {
+                    VertexId vert = frontier[slot];
+                    for (auto edge = offsets[vert]; edge < offsets[vert + 1]; ++edge) {
+                        if (claim(targets[edge])) {
+                            next[worker].push_back(targets[edge]);
+                        }
+                    }
+                }
+            });
+
+            frontier.clear();
+            for (auto& local : next) {
+                frontier.insert(frontier.end(), local.begin(), local.end());
+                local.clear();
+            }
+        }
+    }
+
+    ///
+    /// \brief  Shared Dijkstra/Prim loop; relax(distance to current, edge weight) yields the
+    ///         candidate key of the edge's target
+    template<typename RelaxFn>
+    std::vector<DataT> DoSpanningSearch(
+            const DataT& root, ParentList<DataT>* parents, RelaxFn relax) const {
+        std::vector<VertexId> parent(GetNumVerts(), kNoVertex);
+        std::vector<bool> in_span(GetNumVerts(), false);
+        IndexedHeap<int> kew(GetNumVerts());
+
+        VertexId source = FindId(root);
+        if (source == kNoVertex) {
+            throw std::out_of_range("Search root is not in the graph");
+        }
+
+        kew.Push(source, 0);
+
+        std::vector<DataT> span;
+        while (!kew.IsEmpty()) {
+            VertexId current = kew.PopMin();
+            int current_distance = kew.GetKey(current);
+            in_span[current] = true;
+            span.push_back(m_keys[current]);
+
+            for (auto edge = m_offsets[current]; edge < m_offsets[current + 1]; ++edge) {
+                VertexId candidate = m_targets[edge];
+                if (in_span[candidate]) {
+                    continue;
+                }
+
+                int distance = relax(current_distance, m_weights[edge]);
+                if (!kew.Contains(candidate) || (kew.GetKey(candidate) > distance)) {
+                    kew.Push(candidate, distance);
+                    parent[candidate] = current;
+                }
+            }
+        }
+
+        if (parents != nullptr) {
+            parents->clear();
+            for (VertexId vert = 0; vert < GetNumVerts(); ++vert) {
+                if (parent[vert] != kNoVertex) {
+                    parents->insert(std::make_pair(m_keys[vert], m_keys[parent[vert]]));
+                }
+            }
+        }
+
+        return span;
+    }
+
+    ///
+    /// \brief  Copy in which vertex order[id] becomes id
+    GraphisCSR Permute(const std::vector<VertexId>& order) const {
+        const std::size_t num_verts = GetNumVerts();
+        std::vector<VertexId> renumbered(num_verts);
+        for (VertexId id = 0; id < num_verts; ++id) {
+            renumbered[order[id]] = id;
+        }
+
+        GraphisCSR permuted;
+        permuted.m_is_directed = m_is_directed;
+        permuted.m_keys.reserve(num_verts);
+        permuted.m_targets.reserve(GetNumEdges());
+        permuted.m_weights.reserve(GetNumEdges());
+        for (auto vert : order) {
+            permuted.m_keys.push_back(m_keys[vert]);
+            for (auto edge = m_offsets[vert]; edge < m_offsets[vert + 1]; ++edge) {
+                permuted.m_targets.push_back(renumbered[m_targets[edge]]);
+                permuted.m_weights.push_back(m_weights[edge]);
+            }
+
+            permuted.m_offsets.push_back(permuted.m_targets.size());
+        }
+
+        bool in_key_order = true;
+        permuted.m_key_order.resize(num_verts);
+        for (VertexId rank = 0; rank < num_verts; ++rank) {
+            permuted.m_key_order[rank] = renumbered[IsKeyOrdered() ? rank : m_key_order[rank]];
+            in_key_order = in_key_order && (permuted.m_key_order[rank] == rank);
+        }
+
+        if (in_key_order) {
+            permuted.m_key_order.clear();
+        }
+
+        permuted.BuildInEdges();
+        return permuted;
+    }
+
+    ///
+    /// \brief  Iterative Tarjan; every vertex's leader is the root of its component
+    /// \see    Tarjan, "Depth-First Search and Linear Graph Algorithms", SIAM J. Comput. 1(2), 1972
+    void DoTarjan(std::vector<VertexId>& leader) const {
+        const std::size_t num_verts = GetNumVerts();
+        std::vector<VertexId> index(num_verts, kNoVertex);
+        std::vector<VertexId> lowlink(num_verts);
+        std::vector<bool> on_stack(num_verts, false);
+        std::vector<VertexId> stack;
+        std::vector<std::pair<VertexId, EdgeOffset>> pending;
+        VertexId counter = 0;
+
+        auto discover = [&](VertexId vert) {
+            index[vert] = lowlink[vert] = counter++;
+            stack.push_back(vert);
+            on_stack[vert] = true;
+            pending.push_back(std::make_pair(vert, m_offsets[vert]));
+        };
+
+        for (VertexId root = 0; root < num_verts; ++root) {
+            if (index[root] != kNoVertex) {
+                continue;
+            }
+
+            discover(root);
+            while (!pending.empty()) {
+                VertexId vert = pending.back().first;
+                if (pending.back().second < m_offsets[vert + 1]) {
+                    VertexId next = m_targets[pending.back().second++];
+                    if (index[next] == kNoVertex) {
+                        discover(next);
+                    } else if (on_stack[next]) {
+                        lowlink[vert] = std::min(lowlink[vert], index[next]);
+                    }
+
+                    continue;
+                }
+
+                pending.pop_back();
+                if (!pending.empty()) {
+                    VertexId parent = pending.back().first;
+                    lowlink[parent] = std::min(lowlink[parent], lowlink[vert]);
+                }
+
+                if (lowlink[vert] == index[vert]) {
+                    VertexId member = kNoVertex;
+                    while (member != vert) {
+                        member = stack.back();
+                        stack.pop_back();
+                        on_stack[member] = false;
+                        leader[member] = vert;
+                    }
+                }
+            }
+        }
+    }
+
+    ///
+    /// \brief  Out-degree, plus in-degree for a directed graph
+    EdgeOffset GetDegree(VertexId vert) const {
+        EdgeOffset degree = m_offsets[vert + 1] - m_offsets[vert];
+        return m_is_directed ? degree + m_in_offsets[vert + 1] - m_in_offsets[vert] : degree;
+    }
+
+    ///
+    /// \brief  0..n-1, for the orderings to sort
+    std::vector<VertexId> GetIds() const {
+        std::vector<VertexId> order(GetNumVerts());
+        for (VertexId vert = 0; vert < GetNumVerts(); ++vert) {
+            order[vert] = vert;
+        }
+
+        return order;
+    }
+
+    ///
+    /// \brief  Bellman-Ford distances from a virtual source with a zero-weight arc to every
+    ///         vertex, or all zeros when no weight is negative
+    std::vector<int> GetPotentials() const {
+        const std::size_t num_verts = GetNumVerts();
+        std::vector<int> potential(num_verts, 0);
+        if (std::none_of(m_weights.begin(), m_weights.end(), [](int weight) {
+                return weight < 0;
+            })) {
+            return potential;
+        }
+
+        for (std::size_t pass = 0; pass <= num_verts; ++pass) {
+            bool changed = false;
+            for (VertexId src = 0; src < num_verts; ++src) {
+                for (auto edge = m_offsets[src]; edge < m_offsets[src + 1]; ++edge) {
+                    int distance = potential[src] + m_weights[edge];
+                    if (distance < potential[m_targets[edge]]) {
+                        potential[m_targets[edge]] = distance;
+                        changed = true;
+                    }
+                }
+            }
+
+            if (!changed) {
+                return potential;
+            }
+        }
+
+        throw std::runtime_error("Negative cycle in all-pairs shortest paths");
+    }
+
+    ///
+    /// \brief  Each undirected edge once, from the lo endpoint's out-edges; self-loops dropped
+    std::vector<UndirectedEdge> GetUndirectedEdges() const {
+        std::vector<UndirectedEdge> edges;
+        edges.reserve(GetNumEdges() / 2);
+        for (VertexId vert = 0; vert < GetNumVerts(); ++vert) {
+            for (auto edge = m_offsets[vert]; edge < m_offsets[vert + 1]; ++edge) {
+                if (vert < m_targets[edge]) {
+                    edges.push_back(UndirectedEdge{m_weights[edge], vert, m_targets[edge]});
+                }
+            }
+        }
+
+        return edges;
+    }
+
+    ///
+    /// \brief  target = min(target, through (+) across) over one tile of rows stride apart, the
+    ///         middle vertex outermost so that target may be through or across. The across row
+    ///         is copied to the stack so the compiler can vectorize without aliasing checks.
+    static void RelaxTile(int* target, const int* through, const int* across, std::size_t stride) {
+        int across_row[kFloydTile];
+        for (std::size_t mid = 0; mid < kFloydTile; ++mid) {
+            std::copy(across + mid * stride, across + mid * stride + kFloydTile, across_row);
+            for (std::size_t row = 0; row < kFloydTile; ++row) {
+                const int via = through[row * stride + mid];
+                int* target_row = target + row * stride;
+                for (std::size_t col = 0; col < kFloydTile; ++col) {
+                    target_row[col] = std::min(target_row[col], via + across_row[col]);
+                }
+            }
+        }
+    }
+
+    bool m_is_directed;
+    std::vector<DataT> m_keys;
+    std::vector<EdgeOffset> m_offsets;
+    std::vector<VertexId> m_targets;
+    std::vector<int> m_weights;
+    std::vector<EdgeOffset> m_in_offsets;
+    std::vector<VertexId> m_in_sources;
+    std::vector<int> m_in_weights;
+    std::vector<VertexId> m_key_order;
+};
+
+/// fn      Graphis::Freeze
+template<typename DataT>
+GraphisCSR<DataT> Graphis<DataT>::Freeze() const {
+    return GraphisCSR<DataT>(*this);
+}
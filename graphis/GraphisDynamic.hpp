@@ -0,0 +1,332 @@
+/*! -------------------------------------------------------------------------*\
+|   Single-source shortest paths maintained under edge insertions, reweighting and removal
+|   \see Ramalingam and Reps, "An Incremental Algorithm for a Generalization of the
+|        Shortest-Path Problem", J. Algorithms 21(2), 1996
+\*---------------------------------------------------------------------------*/
+#pragma once
+
+#include "Graphis.hpp"
+#include "GraphisHeap.hpp"
+
+#include <algorithm>
+#include <stack>
+#include <stdexcept>
+#include <vector>
+
+/// \struct RepairStats
+/// \brief  Work done by DynamicShortestPath updates; a vertex is touched when its distance or
+///         parent had to be recomputed
+struct RepairStats {
+    std::size_t num_updates = 0;
+    std::size_t last_touched = 0;
+    std::size_t total_touched = 0;
+};
+
+/// \class  DynamicShortestPath
+/// \brief  Shortest path tree from one root over a Graphis, repaired rather than recomputed
+///         when an edge changes. A cheaper or new edge relaxes outward from its head only; a
+///         dearer or removed tree edge invalidates just the subtree below it, which is reseeded
+///         from its unaffected in-neighbors and settled again with Dijkstra. Edge changes must
+///         go through this class to keep the tree in step with the graph, and weights must not
+///         be negative.
+template<typename DataT>
+class DynamicShortestPath {
+public:
+    ///
+    DynamicShortestPath(Graphis<DataT>& graph, DataT root)
+            : m_graph(graph), m_root(graph.m_vertices.Find(root)), m_kew(0) {
+        if (m_root == kNoVertex) {
+            throw std::invalid_argument("DynamicShortestPath root is not in the graph");
+        }
+
+        Grow();
+        if (m_graph.IsDirected()) {
+            for (VertexId src = 0; src < m_graph.m_edges.size(); ++src) {
+                for (const auto& arc : m_graph.GetArcs(src)) {
+                    m_in_arcs[arc.dest].push_back(AdjacencyArc{src, arc.weight});
+                }
+            }
+        }
+
+        m_distances[m_root] = 0;
+        m_kew.Push(m_root, 0);
+        Settle();
+    }
+
+    ///
+    /// \brief  Adds the edge to the graph; returns the number of vertices it touched
+    std::size_t AddEdge(DataT src, DataT dst, int weight = 0) {
+        CheckWeight(weight);
+        m_graph.AddEdge(src, dst, weight);
+        Grow();
+
+        VertexId src_id = m_graph.m_vertices.Find(src);
+        VertexId dst_id = m_graph.m_vertices.Find(dst);
+        if (m_graph.IsDirected()) {
+            m_in_arcs[dst_id].push_back(AdjacencyArc{src_id, weight});
+        }
+
+        return Record(DecreaseEdge(src_id, dst_id));
+    }
+
+    ///
+    /// \brief  Same contract as Graphis::FindPath
+    void FindPath(DataT end, std::stack<DataT>& path) const {
+        VertexId current = m_graph.m_vertices.Find(end);
+        while ((current != m_root) && (current < m_parents.size())
+               && (m_parents[current] != kNoVertex)) {
+            path.push(m_graph.m_vertices.GetKey(current));
+            current = m_parents[current];
+        }
+
+        path.push(m_graph.m_vertices.GetKey(m_root));
+    }
+
+    ///
+    /// \brief  kUnreachable for vertices with no path from the root
+    int GetDistance(DataT vertex) const {
+        VertexId vert = m_graph.m_vertices.Find(vertex);
+        return (vert < m_distances.size()) ? m_distances[vert] : kUnreachable;
+    }
+
+    ///
+    ParentList<DataT> GetParents() const {
+        ParentList<DataT> parents;
+        for (VertexId vert = 0; vert < m_parents.size(); ++vert) {
+            if (m_parents[vert] != kNoVertex) {
+                const auto& keys = m_graph.m_vertices;
+                parents.insert(std::make_pair(keys.GetKey(vert), keys.GetKey(m_parents[vert])));
+            }
+        }
+
+        return parents;
+    }
+
+    ///
+    const RepairStats& GetStats() const {
+        return m_stats;
+    }
+
+    ///
+    /// \brief  Removes the edge from the graph; returns the number of vertices it touched
+    std::size_t RemoveEdge(DataT src, DataT dst) {
+        if (!m_graph.RemoveEdge(src, dst)) {
+            return Record(0);
+        }
+
+        VertexId src_id = m_graph.m_vertices.Find(src);
+        VertexId dst_id = m_graph.m_vertices.Find(dst);
+        if (m_graph.IsDirected()) {
+            auto& arcs = m_in_arcs[dst_id];
+            arcs.erase(std::remove_if(arcs.begin(),
+                                      arcs.end(),
+                                      [&](const AdjacencyArc& arc) { return arc.dest == src_id; }),
+                       arcs.end());
+        }
+
+        return Record(IncreaseEdge(src_id, dst_id));
+    }
+
+    ///
+    /// \brief  Reweighs the edge in the graph; returns the number of vertices it touched
+    std::size_t SetEdgeWeight(DataT src, DataT dst, int weight) {
+        CheckWeight(weight);
+        VertexId src_id = m_graph.m_vertices.Find(src);
+        VertexId dst_id = m_graph.m_vertices.Find(dst);
+        if ((src_id == kNoVertex) || (dst_id == kNoVertex)) {
+            throw std::invalid_argument("SetEdgeWeight needs an existing edge");
+        }
+
+        int old_weight = GetArcWeight(src_id, dst_id);
+        m_graph.SetEdgeWeight(src, dst, weight);
+
+        if (m_graph.IsDirected()) {
+            for (auto& arc : m_in_arcs[dst_id]) {
+                if (arc.dest == src_id) {
+                    arc.weight = weight;
+                }
+            }
+        }
+
+        if (weight < old_weight) {
+            return Record(DecreaseEdge(src_id, dst_id));
+        }
+
+        if (weight > old_weight) {
+            return Record(IncreaseEdge(src_id, dst_id));
+        }
+
+        return Record(0);
+    }
+
+private:
+    ///
+    static void CheckWeight(int weight) {
+        if (weight < 0) {
+            throw std::invalid_argument("DynamicShortestPath needs non-negative weights");
+        }
+    }
+
+    ///
+    /// \brief  Handles an arc that got cheaper or appeared: relaxes it, then lets Dijkstra
+    ///         carry any improvement downstream
+    std::size_t Decrease(VertexId src, VertexId dst) {
+        int weight = GetArcWeight(src, dst);
+        if ((m_distances[src] == kUnreachable) || (weight == kUnreachable)
+            || (m_distances[src] + weight >= m_distances[dst])) {
+            return 0;
+        }
+
+        m_distances[dst] = m_distances[src] + weight;
+        m_parents[dst] = src;
+        m_kew.Push(dst, m_distances[dst]);
+        return Settle();
+    }
+
+    ///
+    /// \brief  Decrease for src->dst, and for dst->src as well if the graph is undirected
+    std::size_t DecreaseEdge(VertexId src, VertexId dst) {
+        std::size_t touched = Decrease(src, dst);
+        return m_graph.IsDirected() ? touched : touched + Decrease(dst, src);
+    }
+
+    ///
+    template<typename VisitFn>
+    void ForEachInArc(VertexId vert, VisitFn visit) const {
+        if (!m_graph.IsDirected()) {
+            for (const auto& arc : m_graph.GetArcs(vert)) {
+                visit(arc.dest, arc.weight);
+            }
+
+            return;
+        }
+
+        for (const auto& arc : m_in_arcs[vert]) {
+            visit(arc.dest, arc.weight);
+        }
+    }
+
+    ///
+    /// \brief  Cheapest remaining src->dst arc, or kUnreachable
+    int GetArcWeight(VertexId src, VertexId dst) const {
+        int weight = kUnreachable;
+        for (const auto& arc : m_graph.GetArcs(src)) {
+            if (arc.dest == dst) {
+                weight = std::min(weight, arc.weight);
+            }
+        }
+
+        return weight;
+    }
+
+    ///
+    /// \brief  Sizes the per-vertex state for vertices the graph interned since the last call
+    void Grow() {
+        std::size_t num_vertices = m_graph.m_vertices.Size();
+        m_distances.resize(num_vertices, kUnreachable);
+        m_parents.resize(num_vertices, kNoVertex);
+        m_affected.resize(num_vertices, false);
+        m_kew.Reserve(num_vertices);
+        if (m_graph.IsDirected()) {
+            m_in_arcs.resize(num_vertices);
+        }
+    }
+
+    ///
+    /// \brief  Handles an arc that got dearer or vanished. Nothing changes unless it was dst's
+    ///         tree arc and no equally cheap parallel arc is left; otherwise dst's subtree is
+    ///         detached, seeded from in-neighbors outside it and settled again.
+    std::size_t Increase(VertexId src, VertexId dst) {
+        if (m_parents[dst] != src) {
+            return 0;
+        }
+
+        int weight = GetArcWeight(src, dst);
+        if ((weight != kUnreachable) && (m_distances[src] + weight == m_distances[dst])) {
+            return 0;
+        }
+
+        m_subtree.assign(1, dst);
+        m_affected[dst] = true;
+        for (std::size_t next = 0; next < m_subtree.size(); ++next) {
+            VertexId vert = m_subtree[next];
+            for (const auto& arc : m_graph.GetArcs(vert)) {
+                if ((m_parents[arc.dest] == vert) && !m_affected[arc.dest]) {
+                    m_affected[arc.dest] = true;
+                    m_subtree.push_back(arc.dest);
+                }
+            }
+        }
+
+        for (auto vert : m_subtree) {
+            m_distances[vert] = kUnreachable;
+            m_parents[vert] = kNoVertex;
+        }
+
+        for (auto vert : m_subtree) {
+            ForEachInArc(vert, [&](VertexId from, int arc_weight) {
+                if (!m_affected[from] && (m_distances[from] != kUnreachable)
+                    && (m_distances[from] + arc_weight < m_distances[vert])) {
+                    m_distances[vert] = m_distances[from] + arc_weight;
+                    m_parents[vert] = from;
+                }
+            });
+
+            if (m_distances[vert] != kUnreachable) {
+                m_kew.Push(vert, m_distances[vert]);
+            }
+        }
+
+        for (auto vert : m_subtree) {
+            m_affected[vert] = false;
+        }
+
+        Settle();
+        return m_subtree.size();
+    }
+
+    ///
+    /// \brief  Increase for src->dst, and for dst->src as well if the graph is undirected
+    std::size_t IncreaseEdge(VertexId src, VertexId dst) {
+        std::size_t touched = Increase(src, dst);
+        return m_graph.IsDirected() ? touched : touched + Increase(dst, src);
+    }
+
+    ///
+    std::size_t Record(std::size_t touched) {
+        ++m_stats.num_updates;
+        m_stats.last_touched = touched;
+        m_stats.total_touched += touched;
+        return touched;
+    }
+
+    ///
+    /// \brief  Dijkstra from whatever is queued; returns the number of vertices settled
+    std::size_t Settle() {
+        std::size_t settled = 0;
+        while (!m_kew.IsEmpty()) {
+            VertexId current = m_kew.PopMin();
+            ++settled;
+            for (const auto& arc : m_graph.GetArcs(current)) {
+                int distance = m_distances[current] + arc.weight;
+                if (distance < m_distances[arc.dest]) {
+                    m_distances[arc.dest] = distance;
+                    m_parents[arc.dest] = current;
+                    m_kew.Push(arc.dest, distance);
+                }
+            }
+        }
+
+        return settled;
+    }
+
+    Graphis<DataT>& m_graph;
+    VertexId m_root;
+    std::vector<int> m_distances;
+    std::vector<VertexId> m_parents;
+    std::vector<std::vector<AdjacencyArc>> m_in_arcs;
+    IndexedHeap<int> m_kew;
+    std::vector<bool> m_affected;
+    std::vector<VertexId> m_subtree;
+    RepairStats m_stats;
+};
@@ -0,0 +1,241 @@
+/*! -------------------------------------------------------------------------*\
+|   Priority queues over dense vertex ids for Graphis shortest path searches
+|   \see https://en.wikipedia.org/wiki/Binary_heap
+|   \see http://ssp.impulsetrain.com/radix-heap.html
+\*---------------------------------------------------------------------------*/
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/// \class  IndexedHeap
+/// \brief  Binary min-heap of the ids 0..capacity-1, each holding at most one entry, with
+///         decrease-key; equal keys pop in id order
+template<typename KeyT>
+class IndexedHeap {
+public:
+    ///
+    explicit IndexedHeap(std::size_t capacity) : m_position(capacity, kAbsent), m_keys(capacity) {}
+
+    ///
+    /// \brief  Empties the heap in O(size), so one heap can be reused across searches
+    void Clear() {
+        for (auto index : m_heap) {
+            m_position[index] = kAbsent;
+        }
+
+        m_heap.clear();
+    }
+
+    ///
+    bool Contains(std::uint32_t index) const {
+        return m_position[index] != kAbsent;
+    }
+
+    ///
+    bool IsEmpty() const {
+        return m_heap.empty();
+    }
+
+    ///
+    KeyT GetKey(std::uint32_t index) const {
+        return m_keys[index];
+    }
+
+    ///
+    std::uint32_t PopMin() {
+        std::uint32_t top = m_heap.front();
+        Swap(0, m_heap.size() - 1);
+        m_heap.pop_back();
+        m_position[top] = kAbsent;
+        if (!m_heap.empty()) {
+            SiftDown(0);
+        }
+
+        return top;
+    }
+
+    ///
+    /// \brief  Inserts index, or lowers its key if it is already queued with a larger one
+    void Push(std::uint32_t index, KeyT key) {
+        if (!Contains(index)) {
+            m_keys[index] = key;
+            m_position[index] = m_heap.size();
+            m_heap.push_back(index);
+            SiftUp(m_heap.size() - 1);
+        } else if (key < m_keys[index]) {
+            m_keys[index] = key;
+            SiftUp(m_position[index]);
+        }
+    }
+
+    ///
+    /// \brief  Grows the id range to 0..capacity-1, keeping queued entries
+    void Reserve(std::size_t capacity) {
+        if (capacity > m_position.size()) {
+            m_position.resize(capacity, kAbsent);
+            m_keys.resize(capacity);
+        }
+    }
+
+    ///
+    std::size_t Size() const {
+        return m_heap.size();
+    }
+
+    ///
+    std::uint32_t Top() const {
+        return m_heap.front();
+    }
+
+    ///
+    /// \brief  Inserts index, or moves it to key whether that is larger or smaller
+    void Update(std::uint32_t index, KeyT key) {
+        if (!Contains(index)) {
+            Push(index, key);
+            return;
+        }
+
+        m_keys[index] = key;
+        SiftUp(m_position[index]);
+        SiftDown(m_position[index]);
+    }
+
+private:
+    static constexpr std::size_t kAbsent = std::numeric_limits<std::size_t>::max();
+
+    ///
+    bool Less(std::size_t lhs, std::size_t rhs) const {
+        std::uint32_t left = m_heap[lhs];
+        std::uint32_t right = m_heap[rhs];
+        return (m_keys[left] < m_keys[right])
+               || (!(m_keys[right] < m_keys[left]) && (left < right));
+    }
+
+    ///
+    void SiftDown(std::size_t slot) {
+        for (;;) {
+            std::size_t smallest = slot;
+            std::size_t left = 2 * slot + 1;
+            std::size_t right = left + 1;
+            if ((left < m_heap.size()) && Less(left, smallest)) {
+                smallest = left;
+            }
+
+            if ((right < m_heap.size()) && Less(right, smallest)) {
+                smallest = right;
+            }
+
+            if (smallest == slot) {
+                return;
+            }
+
+            Swap(slot, smallest);
+            slot = smallest;
+        }
+    }
+
+    ///
+    void SiftUp(std::size_t slot) {
+        while (slot > 0) {
+            std::size_t parent = (slot - 1) / 2;
+            if (!Less(slot, parent)) {
+                return;
+            }
+
+            Swap(slot, parent);
+            slot = parent;
+        }
+    }
+
+    ///
+    void Swap(std::size_t lhs, std::size_t rhs) {
+        std::swap(m_heap[lhs], m_heap[rhs]);
+        m_position[m_heap[lhs]] = lhs;
+        m_position[m_heap[rhs]] = rhs;
+    }
+
+    std::vector<std::uint32_t> m_heap;
+    std::vector<std::size_t> m_position;
+    std::vector<KeyT> m_keys;
+};
+
+/// \class  RadixHeap
+/// \brief  Monotone priority queue for non-negative integer keys: every pushed key must be at
+///         least the last popped one, as in Dijkstra with non-negative weights. Entries are not
+///         deduplicated, so callers skip stale pops themselves.
+class RadixHeap {
+public:
+    using Entry = std::pair<std::uint32_t, std::uint32_t>;
+
+    ///
+    RadixHeap() : m_last(0), m_size(0), m_buckets(kNumBuckets) {}
+
+    ///
+    bool IsEmpty() const {
+        return m_size == 0;
+    }
+
+    ///
+    /// \brief  Returns (key, index) of a minimum entry
+    Entry PopMin() {
+        if (m_buckets[0].empty()) {
+            std::size_t bucket = 1;
+            while (m_buckets[bucket].empty()) {
+                ++bucket;
+            }
+
+            m_last = std::numeric_limits<std::uint32_t>::max();
+            for (const auto& entry : m_buckets[bucket]) {
+                m_last = std::min(m_last, entry.first);
+            }
+
+            for (const auto& entry : m_buckets[bucket]) {
+                m_buckets[BucketOf(entry.first)].push_back(entry);
+            }
+
+            m_buckets[bucket].clear();
+        }
+
+        Entry top = m_buckets[0].back();
+        m_buckets[0].pop_back();
+        --m_size;
+        return top;
+    }
+
+    ///
+    void Push(std::uint32_t index, std::uint32_t key) {
+        if (key < m_last) {
+            throw std::invalid_argument("RadixHeap keys must not decrease below the last pop");
+        }
+
+        m_buckets[BucketOf(key)].push_back(std::make_pair(key, index));
+        ++m_size;
+    }
+
+    ///
+    std::size_t Size() const {
+        return m_size;
+    }
+
+private:
+    static constexpr std::size_t kNumBuckets = 33;
+
+    /// Bucket b > 0 holds keys whose highest bit differing from m_last is bit b - 1
+    std::size_t BucketOf(std::uint32_t key) const {
+        std::size_t bucket = 0;
+        for (std::uint32_t diff = key ^ m_last; diff != 0; diff >>= 1) {
+            ++bucket;
+        }
+
+        return bucket;
+    }
+
+    std::uint32_t m_last;
+    std::size_t m_size;
+    std::vector<std::vector<Entry>> m_buckets;
+};
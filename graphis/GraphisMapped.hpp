@@ -0,0 +1,548 @@
+/*! -------------------------------------------------------------------------*\
+|   Memory-mapped binary Graphis files: write once, open in constant time
+|   \see https://man7.org/linux/man-pages/man2/mmap.2.html
+\*---------------------------------------------------------------------------*/
+#pragma once
+
+#include "GraphisCSR.hpp"
+#include "GraphisHeap.hpp"
+#include "GraphisSerialize.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// \class  ArrayView
+/// \brief  Read-only, non-owning view of a contiguous array
+template<typename T>
+class ArrayView {
+public:
+    using value_type = T;
+    using const_iterator = const T*;
+    using iterator = const T*;
+
+    ///
+    ArrayView() : m_data(nullptr), m_size(0) {}
+
+    ///
+    ArrayView(const T* data, std::size_t size) : m_data(data), m_size(size) {}
+
+    ///
+    const T& operator[](std::size_t index) const {
+        return m_data[index];
+    }
+
+    ///
+    const T* begin() const {
+        return m_data;
+    }
+
+    ///
+    const T* data() const {
+        return m_data;
+    }
+
+    ///
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    ///
+    const T* end() const {
+        return m_data + m_size;
+    }
+
+    ///
+    std::size_t size() const {
+        return m_size;
+    }
+
+private:
+    const T* m_data;
+    std::size_t m_size;
+};
+
+/// \class  MappedFile
+/// \brief  Whole file mapped read-only; pages are faulted in on first touch, so opening costs
+///         the same for any file size
+class MappedFile {
+public:
+    ///
+    explicit MappedFile(const std::string& path) : m_data(nullptr), m_size(0) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open " + path);
+        }
+
+        struct stat status;
+        if (::fstat(fd, &status) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat " + path);
+        }
+
+        m_size = static_cast<std::size_t>(status.st_size);
+        if (m_size > 0) {
+            void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map " + path);
+            }
+
+            m_data = static_cast<const char*>(data);
+        }
+
+        ::close(fd);
+    }
+
+    ///
+    ~MappedFile() {
+        if (m_data != nullptr) {
+            ::munmap(const_cast<char*>(m_data), m_size);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ///
+    const char* GetData() const {
+        return m_data;
+    }
+
+    ///
+    std::size_t GetSize() const {
+        return m_size;
+    }
+
+private:
+    const char* m_data;
+    std::size_t m_size;
+};
+
+/// \struct MappedKeyTable
+/// \brief  Sorted vertex keys as laid out in a mapped file; specialized for arithmetic keys,
+///         stored as a plain array, and std::string, stored as an offset table into one blob
+template<typename DataT, typename Enable = void>
+struct MappedKeyTable;
+
+///
+template<typename DataT>
+struct MappedKeyTable<DataT, typename std::enable_if<std::is_arithmetic<DataT>::value>::type> {
+    /// Identifies the key type in the file header
+    static constexpr std::uint32_t kTag = (std::is_floating_point<DataT>::value ? 0x200 : 0)
+                                          | (std::is_signed<DataT>::value ? 0x100 : 0)
+                                          | sizeof(DataT);
+
+    ///
+    MappedKeyTable() {}
+
+    ///
+    /// \brief  Throws std::runtime_error unless bytes holds exactly num_verts keys
+    MappedKeyTable(const char* data, std::uint64_t bytes, std::uint64_t num_verts) {
+        if (bytes != num_verts * sizeof(DataT)) {
+            throw std::runtime_error("Mapped Graphis key table has the wrong size");
+        }
+
+        m_keys = ArrayView<DataT>(reinterpret_cast<const DataT*>(data), num_verts);
+    }
+
+    ///
+    static std::uint64_t Bytes(const std::vector<DataT>& keys) {
+        return keys.size() * sizeof(DataT);
+    }
+
+    ///
+    VertexId Find(const DataT& key) const {
+        auto keyit = std::lower_bound(m_keys.begin(), m_keys.end(), key);
+        if ((keyit == m_keys.end()) || (key < *keyit)) {
+            return kNoVertex;
+        }
+
+        return static_cast<VertexId>(keyit - m_keys.begin());
+    }
+
+    ///
+    DataT Get(VertexId vertex) const {
+        return m_keys[vertex];
+    }
+
+    ///
+    static void Write(std::ostream& out, const std::vector<DataT>& keys) {
+        out.write(reinterpret_cast<const char*>(keys.data()), Bytes(keys));
+    }
+
+private:
+    ArrayView<DataT> m_keys;
+};
+
+///
+template<>
+struct MappedKeyTable<std::string> {
+    /// Identifies the key type in the file header
+    static constexpr std::uint32_t kTag = 0x1000;
+
+    ///
+    MappedKeyTable() {}
+
+    ///
+    /// \brief  Checks only the table's own bounds, so opening stays constant time
+    MappedKeyTable(const char* data, std::uint64_t bytes, std::uint64_t num_verts) {
+        std::uint64_t table_bytes = (num_verts + 1) * sizeof(std::uint64_t);
+        if (bytes < table_bytes) {
+            throw std::runtime_error("Mapped Graphis key table has the wrong size");
+        }
+
+        m_offsets = ArrayView<std::uint64_t>(
+                reinterpret_cast<const std::uint64_t*>(data), num_verts + 1);
+        m_blob = data + table_bytes;
+        if ((m_offsets[0] != 0) || (m_offsets[num_verts] != bytes - table_bytes)) {
+            throw std::runtime_error("Mapped Graphis key table has the wrong size");
+        }
+    }
+
+    ///
+    static std::uint64_t Bytes(const std::vector<std::string>& keys) {
+        std::uint64_t bytes = (keys.size() + 1) * sizeof(std::uint64_t);
+        for (const auto& key : keys) {
+            bytes += key.size();
+        }
+
+        return bytes;
+    }
+
+    ///
+    /// \brief  Binary search comparing in place, without materializing any key
+    VertexId Find(const std::string& key) const {
+        std::size_t lo = 0;
+        std::size_t hi = m_offsets.size() - 1;
+        while (lo < hi) {
+            std::size_t mid = lo + (hi - lo) / 2;
+            if (Compare(mid, key) < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+
+        if ((lo == m_offsets.size() - 1) || (Compare(lo, key) != 0)) {
+            return kNoVertex;
+        }
+
+        return static_cast<VertexId>(lo);
+    }
+
+    ///
+    std::string Get(VertexId vertex) const {
+        return std::string(m_blob + m_offsets[vertex], m_offsets[vertex + 1] - m_offsets[vertex]);
+    }
+
+    ///
+    static void Write(std::ostream& out, const std::vector<std::string>& keys) {
+        std::uint64_t offset = 0;
+        WritePod(out, offset);
+        for (const auto& key : keys) {
+            offset += key.size();
+            WritePod(out, offset);
+        }
+
+        for (const auto& key : keys) {
+            out.write(key.data(), key.size());
+        }
+    }
+
+private:
+    /// Orders key vertex against key like std::string::compare
+    int Compare(std::size_t vertex, const std::string& key) const {
+        std::size_t length = m_offsets[vertex + 1] - m_offsets[vertex];
+        int order = std::memcmp(
+                m_blob + m_offsets[vertex], key.data(), std::min(length, key.size()));
+        if (order != 0) {
+            return order;
+        }
+
+        return (length < key.size()) ? -1 : ((length > key.size()) ? 1 : 0);
+    }
+
+    ArrayView<std::uint64_t> m_offsets;
+    const char* m_blob = nullptr;
+};
+
+/// \class  MappedGraphis
+/// \brief  Read-only graph served straight from a file written by Save. Open maps the file and
+///         checks the fixed-size header; the key table and CSR arrays are used in place, so
+///         nothing is parsed or copied and startup does not grow with the graph. Vertex ids and
+///         arc order match GraphisCSR. Files use the writer's byte order.
+template<typename DataT>
+class MappedGraphis {
+public:
+    ///
+    std::vector<DataT> BreadthFirstSearch(const DataT& root) const {
+        std::vector<DataT> bfs;
+        std::vector<bool> discovered(GetNumVerts(), false);
+        std::queue<VertexId> kew;
+
+        VertexId source = FindId(root);
+        discovered.at(source) = true;
+        kew.push(source);
+        while (!kew.empty()) {
+            VertexId current = kew.front();
+            kew.pop();
+            bfs.push_back(m_keys.Get(current));
+
+            for (auto edge = m_offsets[current]; edge < m_offsets[current + 1]; ++edge) {
+                VertexId vert = m_targets[edge];
+                if (!discovered[vert]) {
+                    discovered[vert] = true;
+                    kew.push(vert);
+                }
+            }
+        }
+
+        return bfs;
+    }
+
+    ///
+    VertexId FindId(const DataT& key) const {
+        return m_keys.Find(key);
+    }
+
+    ///
+    DataT GetKey(VertexId vertex) const {
+        return m_keys.Get(vertex);
+    }
+
+    ///
+    std::size_t GetNumEdges() const {
+        return m_targets.size();
+    }
+
+    ///
+    std::size_t GetNumVerts() const {
+        return m_offsets.size() - 1;
+    }
+
+    ///
+    const ArrayView<EdgeOffset>& GetOffsets() const {
+        return m_offsets;
+    }
+
+    ///
+    const ArrayView<VertexId>& GetTargets() const {
+        return m_targets;
+    }
+
+    ///
+    const ArrayView<int>& GetWeights() const {
+        return m_weights;
+    }
+
+    ///
+    bool IsDirected() const {
+        return m_is_directed;
+    }
+
+    ///
+    /// \brief  Maps a file written by Save; throws std::runtime_error if it cannot be mapped,
+    ///         was written for another key type or version, or its sections do not fit
+    static MappedGraphis Open(const std::string& path) {
+        MappedGraphis graph;
+        graph.m_file = std::make_shared<MappedFile>(path);
+
+        const char* base = graph.m_file->GetData();
+        const std::uint64_t size = graph.m_file->GetSize();
+        if (size < sizeof(Header)) {
+            throw std::runtime_error("Not a mapped Graphis file: " + path);
+        }
+
+        Header header;
+        std::memcpy(&header, base, sizeof(Header));
+        if ((header.magic != kMagic) || (header.version != kVersion)) {
+            throw std::runtime_error("Not a mapped Graphis file: " + path);
+        }
+
+        if (header.key_tag != MappedKeyTable<DataT>::kTag) {
+            throw std::runtime_error("Mapped Graphis file has another key type: " + path);
+        }
+
+        const std::uint64_t num_verts = header.num_verts;
+        const std::uint64_t num_edges = header.num_edges;
+        if ((header.file_bytes != size) || (num_verts >= size) || (num_edges > size)
+            || !FitsSection(header.keys_offset, header.keys_bytes, size)
+            || !FitsSection(header.offsets_offset, (num_verts + 1) * sizeof(EdgeOffset), size)
+            || !FitsSection(header.targets_offset, num_edges * sizeof(VertexId), size)
+            || !FitsSection(header.weights_offset, num_edges * sizeof(int), size)) {
+            throw std::runtime_error("Mapped Graphis file is truncated: " + path);
+        }
+
+        graph.m_is_directed = header.is_directed != 0;
+        graph.m_keys =
+                MappedKeyTable<DataT>(base + header.keys_offset, header.keys_bytes, num_verts);
+        graph.m_offsets = ArrayView<EdgeOffset>(
+                reinterpret_cast<const EdgeOffset*>(base + header.offsets_offset), num_verts + 1);
+        graph.m_targets = ArrayView<VertexId>(
+                reinterpret_cast<const VertexId*>(base + header.targets_offset), num_edges);
+        graph.m_weights = ArrayView<int>(
+                reinterpret_cast<const int*>(base + header.weights_offset), num_edges);
+        if ((graph.m_offsets[0] != 0) || (graph.m_offsets[num_verts] != num_edges)) {
+            throw std::runtime_error("Mapped Graphis file has inconsistent offsets: " + path);
+        }
+
+        return graph;
+    }
+
+    ///
+    static void Save(const Graphis<DataT>& graph, std::ostream& out) {
+        Save(graph.Freeze(), out);
+    }
+
+    ///
+    /// \brief  Writes the header, then the key table and CSR offsets, targets and weights, each
+    ///         section starting on an 8-byte boundary. Readers look keys up by binary search, so
+    ///         a GraphisCSR::Reorder copy is refused with std::invalid_argument.
+    static void Save(const GraphisCSR<DataT>& graph, std::ostream& out) {
+        if (!graph.IsKeyOrdered()) {
+            throw std::invalid_argument("Mapped Graphis files need vertices in key order");
+        }
+
+        Header header{};
+        header.magic = kMagic;
+        header.version = kVersion;
+        header.key_tag = MappedKeyTable<DataT>::kTag;
+        header.is_directed = graph.IsDirected() ? 1 : 0;
+        header.num_verts = graph.GetNumVerts();
+        header.num_edges = graph.GetNumEdges();
+        header.keys_offset = Align(sizeof(Header));
+        header.keys_bytes = MappedKeyTable<DataT>::Bytes(graph.GetVertexList());
+        header.offsets_offset = Align(header.keys_offset + header.keys_bytes);
+        header.targets_offset =
+                Align(header.offsets_offset + (header.num_verts + 1) * sizeof(EdgeOffset));
+        header.weights_offset =
+                Align(header.targets_offset + header.num_edges * sizeof(VertexId));
+        header.file_bytes = header.weights_offset + header.num_edges * sizeof(int);
+
+        std::uint64_t written = 0;
+        auto pad_to = [&](std::uint64_t offset) {
+            for (; written < offset; ++written) {
+                out.put(0);
+            }
+        };
+
+        WritePod(out, header);
+        written = sizeof(Header);
+        pad_to(header.keys_offset);
+        MappedKeyTable<DataT>::Write(out, graph.GetVertexList());
+        written += header.keys_bytes;
+        pad_to(header.offsets_offset);
+        WriteArray(out, graph.GetOffsets(), written);
+        pad_to(header.targets_offset);
+        WriteArray(out, graph.GetTargets(), written);
+        pad_to(header.weights_offset);
+        WriteArray(out, graph.GetWeights(), written);
+    }
+
+    ///
+    /// \brief  Dijkstra from src that stops once dst is settled
+    PathResult<DataT> ShortestPath(const DataT& src, const DataT& dst) const {
+        PathResult<DataT> result;
+        VertexId source = FindId(src);
+        VertexId target = FindId(dst);
+        if ((source == kNoVertex) || (target == kNoVertex)) {
+            return result;
+        }
+
+        std::vector<int> distances(GetNumVerts(), kUnreachable);
+        std::vector<VertexId> parents(GetNumVerts(), kNoVertex);
+        IndexedHeap<int> kew(GetNumVerts());
+        distances[source] = 0;
+        kew.Push(source, 0);
+        while (!kew.IsEmpty()) {
+            VertexId current = kew.PopMin();
+            ++result.settled;
+            if (current == target) {
+                break;
+            }
+
+            for (auto edge = m_offsets[current]; edge < m_offsets[current + 1]; ++edge) {
+                VertexId candidate = m_targets[edge];
+                int distance = distances[current] + m_weights[edge];
+                if (distances[candidate] > distance) {
+                    distances[candidate] = distance;
+                    parents[candidate] = current;
+                    kew.Push(candidate, distance);
+                }
+            }
+        }
+
+        if (distances[target] == kUnreachable) {
+            return result;
+        }
+
+        result.distance = distances[target];
+        for (VertexId vert = target; vert != kNoVertex; vert = parents[vert]) {
+            result.path.push_back(m_keys.Get(vert));
+        }
+
+        std::reverse(result.path.begin(), result.path.end());
+        return result;
+    }
+
+private:
+    static constexpr std::uint32_t kMagic = 0x464d5247;  // "GRMF"
+    static constexpr std::uint32_t kVersion = 1;
+
+    /// \struct Header
+    /// \brief  Fixed-size file header; section offsets are from the start of the file
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t key_tag;
+        std::uint32_t is_directed;
+        std::uint64_t num_verts;
+        std::uint64_t num_edges;
+        std::uint64_t keys_offset;
+        std::uint64_t keys_bytes;
+        std::uint64_t offsets_offset;
+        std::uint64_t targets_offset;
+        std::uint64_t weights_offset;
+        std::uint64_t file_bytes;
+    };
+
+    ///
+    MappedGraphis() : m_is_directed(false) {}
+
+    ///
+    static std::uint64_t Align(std::uint64_t offset) {
+        return (offset + 7) & ~std::uint64_t(7);
+    }
+
+    ///
+    static bool FitsSection(std::uint64_t offset, std::uint64_t bytes, std::uint64_t size) {
+        return (offset % 8 == 0) && (offset <= size) && (bytes <= size - offset);
+    }
+
+    ///
+    template<typename PodT>
+    static void WriteArray(
+            std::ostream& out, const std::vector<PodT>& values, std::uint64_t& written) {
+        out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(PodT));
+        written += values.size() * sizeof(PodT);
+    }
+
+    std::shared_ptr<MappedFile> m_file;
+    bool m_is_directed;
+    MappedKeyTable<DataT> m_keys;
+    ArrayView<EdgeOffset> m_offsets;
+    ArrayView<VertexId> m_targets;
+    ArrayView<int> m_weights;
+};
@@ -0,0 +1,247 @@
+/*! -------------------------------------------------------------------------*\
+|   Minimal fork-join worker team for the parallel Graphis engines
+\*---------------------------------------------------------------------------*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// \class  WorkerTeam
+/// \brief  Keeps num_threads - 1 threads parked between jobs so that level-synchronous
+///         algorithms pay the thread start-up cost once per call rather than once per level.
+///         The calling thread acts as worker 0. An exception thrown by a job is carried back
+///         to the caller once every worker has finished.
+class WorkerTeam {
+public:
+    ///
+    /// \brief  num_threads == 0 uses std::thread::hardware_concurrency()
+    explicit WorkerTeam(unsigned num_threads = 0)
+            : m_size(ResolveThreads(num_threads)), m_generation(0), m_pending(0), m_stop(false) {
+        for (unsigned worker = 1; worker < m_size; ++worker) {
+            m_threads.emplace_back([this, worker] { WorkerLoop(worker); });
+        }
+    }
+
+    ///
+    ~WorkerTeam() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+            ++m_generation;
+        }
+
+        m_wake.notify_all();
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    WorkerTeam(const WorkerTeam&) = delete;
+    WorkerTeam& operator=(const WorkerTeam&) = delete;
+
+    ///
+    /// \brief  Splits [begin, end) into chunks of about grain items that workers claim
+    ///         dynamically; fn(worker, chunk_begin, chunk_end) runs once per chunk
+    template<typename ChunkFn>
+    void ForEach(std::size_t begin, std::size_t end, ChunkFn fn, std::size_t grain = 0) {
+        if (begin >= end) {
+            return;
+        }
+
+        if (grain == 0) {
+            grain = std::max<std::size_t>(64, (end - begin) / (8 * m_size));
+        }
+
+        std::atomic<std::size_t> next(begin);
+        Run([&](unsigned worker) {
+            for (;;) {
+                std::size_t chunk = next.fetch_add(grain, std::memory_order_relaxed);
+                if (chunk >= end) {
+                    return;
+                }
+
+                try {
+                    fn(worker, chunk, std::min(end, chunk + grain));
+                } catch (...) {
+                    // Leave the remaining chunks unclaimed so the other workers stop early
+                    next.store(end, std::memory_order_relaxed);
+                    throw;
+                }
+            }
+        });
+    }
+
+    ///
+    /// \brief  Runs job(worker) on every worker and returns once all of them have finished,
+    ///         rethrowing the first exception any of them threw
+    void Run(const std::function<void(unsigned)>& job) {
+        if (m_size == 1) {
+            job(0);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_job = &job;
+            m_pending = m_size - 1;
+            ++m_generation;
+        }
+
+        m_wake.notify_all();
+        RunGuarded(job, 0);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_pending == 0; });
+        m_job = nullptr;
+        std::exception_ptr error = nullptr;
+        std::swap(error, m_error);
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    ///
+    unsigned Size() const {
+        return m_size;
+    }
+
+    ///
+    static unsigned ResolveThreads(unsigned num_threads) {
+        if (num_threads == 0) {
+            num_threads = std::thread::hardware_concurrency();
+        }
+
+        return std::max(1u, num_threads);
+    }
+
+private:
+    ///
+    /// \brief  Runs job(worker), keeping the first exception thrown during this Run
+    void RunGuarded(const std::function<void(unsigned)>& job, unsigned worker) {
+        try {
+            job(worker);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+        }
+    }
+
+    ///
+    void WorkerLoop(unsigned worker) {
+        std::uint64_t seen = 0;
+        for (;;) {
+            const std::function<void(unsigned)>* job = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&] { return m_generation != seen; });
+                seen = m_generation;
+                if (m_stop) {
+                    return;
+                }
+
+                job = m_job;
+            }
+
+            RunGuarded(*job, worker);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_pending == 0) {
+                m_done.notify_one();
+            }
+        }
+    }
+
+    unsigned m_size;
+    std::uint64_t m_generation;
+    unsigned m_pending;
+    bool m_stop;
+    const std::function<void(unsigned)>* m_job = nullptr;
+    std::exception_ptr m_error;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::vector<std::thread> m_threads;
+};
+
+/// fn      ParallelSort
+/// \brief  Sorts chunks on the team's workers, then merges neighbouring runs pairwise, each
+///         round's merges running in parallel. Not stable unless less breaks every tie.
+template<typename RandomIt, typename LessFn>
+void ParallelSort(WorkerTeam& team, RandomIt first, RandomIt last, LessFn less) {
+    const std::size_t size = last - first;
+    const std::size_t num_runs =
+            std::min<std::size_t>(team.Size(), std::max<std::size_t>(1, size / 4096));
+    const std::size_t run_size = (size + num_runs - 1) / num_runs;
+
+    auto run_begin = [&](std::size_t run) {
+        return first + std::min(size, run * run_size);
+    };
+
+    team.ForEach(
+            0,
+            num_runs,
+            [&](unsigned, std::size_t lo, std::size_t hi) {
+                for (auto run = lo; run < hi; ++run) {
+                    std::sort(run_begin(run), run_begin(run + 1), less);
+                }
+            },
+            1);
+
+    for (std::size_t width = 1; width < num_runs; width *= 2) {
+        team.ForEach(
+                0,
+                (num_runs + 2 * width - 1) / (2 * width),
+                [&](unsigned, std::size_t lo, std::size_t hi) {
+                    for (auto pair = lo; pair < hi; ++pair) {
+                        std::size_t left = 2 * width * pair;
+                        std::inplace_merge(run_begin(left),
+                                           run_begin(std::min(num_runs, left + width)),
+                                           run_begin(std::min(num_runs, left + 2 * width)),
+                                           less);
+                    }
+                },
+                1);
+    }
+}
+
+/// \class  AtomicBitmap
+/// \brief  Fixed-size bit set whose bits can be claimed concurrently
+class AtomicBitmap {
+public:
+    ///
+    explicit AtomicBitmap(std::size_t num_bits) : m_words((num_bits + 63) / 64) {
+        Clear();
+    }
+
+    ///
+    void Clear() {
+        for (auto& word : m_words) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ///
+    bool Get(std::size_t bit) const {
+        return (m_words[bit / 64].load(std::memory_order_relaxed) >> (bit % 64)) & 1;
+    }
+
+    ///
+    /// \brief  Sets bit and returns true if this call is the one that set it
+    bool TrySet(std::size_t bit) {
+        std::uint64_t mask = std::uint64_t(1) << (bit % 64);
+        return !(m_words[bit / 64].fetch_or(mask, std::memory_order_relaxed) & mask);
+    }
+
+private:
+    std::vector<std::atomic<std::uint64_t>> m_words;
+};
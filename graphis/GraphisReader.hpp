@@ -0,0 +1,270 @@
+/*! -------------------------------------------------------------------------*\
+|   Streaming DIMACS and SNAP edge list readers for Graphis
+|   \see http://www.diag.uniroma1.it/challenge9/format.shtml#graph
+|   \see https://snap.stanford.edu/data/
+\*---------------------------------------------------------------------------*/
+#pragma once
+
+#include "Graphis.hpp"
+#include "GraphisParallel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// \enum   EdgeFormat
+/// \brief  DIMACS shortest path files ("a src dst weight" arcs, "c" comments, one "p sp" line)
+///         or SNAP edge lists ("src dst" or "src dst weight" lines, "#" comments)
+enum class EdgeFormat { EF_DIMACS, EF_SNAP };
+
+/// \class  EdgeListParser
+/// \brief  Turns buffers of complete lines into edges with a hand-rolled integer scanner;
+///         byte offsets in error messages are relative to the start of the file
+template<typename DataT>
+class EdgeListParser {
+    static_assert(std::is_integral<DataT>::value, "Edge lists name vertices by integer");
+
+public:
+    ///
+    explicit EdgeListParser(EdgeFormat format) : m_format(format) {}
+
+    ///
+    /// \brief  Parses every line in [first, last), which must end on a line boundary or at the
+    ///         end of the file; base is the file offset of first
+    void Parse(
+            const char* first,
+            const char* last,
+            std::uint64_t base,
+            std::vector<WeightedEdge<DataT>>& edges) const {
+        while (first < last) {
+            const char* eol = first;
+            while ((eol < last) && (*eol != '\n')) {
+                ++eol;
+            }
+
+            ParseLine(first, eol, base, edges);
+            base += eol - first + 1;
+            first = eol + 1;
+        }
+    }
+
+private:
+    ///
+    static bool IsBlank(char ch) {
+        return (ch == ' ') || (ch == '\t') || (ch == '\r');
+    }
+
+    ///
+    /// \brief  True if value survives the narrowing to T unchanged
+    template<typename T>
+    static bool Fits(std::int64_t value) {
+        if (value < 0) {
+            return std::is_signed<T>::value &&
+                   (value >= static_cast<std::int64_t>(std::numeric_limits<T>::min()));
+        }
+
+        return static_cast<std::uint64_t>(value) <=
+               static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+    }
+
+    ///
+    /// \brief  Skips blanks, then reads an optionally signed decimal; false if there is none,
+    ///         if it overflows std::int64_t, or if separated is set and no blank precedes it
+    static bool ParseInteger(
+            const char*& cursor, const char* last, std::int64_t& value, bool separated) {
+        const char* start = cursor;
+        while ((cursor < last) && IsBlank(*cursor)) {
+            ++cursor;
+        }
+
+        if (separated && (cursor == start)) {
+            return false;
+        }
+
+        bool negative = (cursor < last) && (*cursor == '-');
+        cursor += negative ? 1 : 0;
+
+        const char* digits = cursor;
+        std::int64_t magnitude = 0;
+        while ((cursor < last) && (*cursor >= '0') && (*cursor <= '9')) {
+            if (magnitude > (std::numeric_limits<std::int64_t>::max() - (*cursor - '0')) / 10) {
+                return false;
+            }
+
+            magnitude = 10 * magnitude + (*cursor - '0');
+            ++cursor;
+        }
+
+        value = negative ? -magnitude : magnitude;
+        return cursor != digits;
+    }
+
+    ///
+    void ParseLine(
+            const char* first,
+            const char* last,
+            std::uint64_t offset,
+            std::vector<WeightedEdge<DataT>>& edges) const {
+        const char* cursor = first;
+        while ((cursor < last) && IsBlank(*cursor)) {
+            ++cursor;
+        }
+
+        if (cursor == last) {
+            return;
+        }
+
+        if (m_format == EdgeFormat::EF_DIMACS) {
+            if ((*cursor == 'c') || (*cursor == 'p')) {
+                return;
+            }
+
+            if (*cursor != 'a') {
+                throw std::runtime_error(
+                        "Unexpected DIMACS line at byte " + std::to_string(offset));
+            }
+
+            ++cursor;
+        } else if ((*cursor == '#') || (*cursor == '%')) {
+            return;
+        }
+
+        std::int64_t src = 0;
+        std::int64_t dst = 0;
+        std::int64_t weight = 0;
+        // Every field after the tag (or after the first, for SNAP) needs a blank in front
+        bool tagged = (m_format == EdgeFormat::EF_DIMACS);
+        if (!ParseInteger(cursor, last, src, tagged) || !ParseInteger(cursor, last, dst, true) ||
+            !Fits<DataT>(src) || !Fits<DataT>(dst)) {
+            throw std::runtime_error("Malformed edge at byte " + std::to_string(offset));
+        }
+
+        bool has_weight = ParseInteger(cursor, last, weight, true);
+        while ((cursor < last) && IsBlank(*cursor)) {
+            ++cursor;
+        }
+
+        if ((cursor != last) || (tagged && !has_weight) || !Fits<int>(weight)) {
+            throw std::runtime_error("Malformed edge at byte " + std::to_string(offset));
+        }
+
+        edges.push_back(WeightedEdge<DataT>{
+                static_cast<DataT>(src), static_cast<DataT>(dst), static_cast<int>(weight)});
+    }
+
+    EdgeFormat m_format;
+};
+
+/// fn      ParseEdgeList
+/// \brief  Reads path in fixed-size chunks, carrying each chunk's partial last line into the
+///         next. With more than one thread the file is cut into slices at line boundaries and
+///         each worker streams its own slice; the edges come back in file order either way.
+///         num_threads == 0 uses std::thread::hardware_concurrency().
+template<typename DataT>
+std::vector<WeightedEdge<DataT>> ParseEdgeList(
+        const std::string& path, EdgeFormat format, unsigned num_threads = 1) {
+    constexpr std::size_t kChunkBytes = 1 << 20;
+    constexpr std::uint64_t kMinSliceBytes = 1 << 16;
+
+    auto open = [&]() {
+        std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(
+                std::fopen(path.c_str(), "rb"), &std::fclose);
+        if (!file) {
+            throw std::runtime_error("Cannot open " + path);
+        }
+
+        return file;
+    };
+
+    auto file = open();
+    std::fseek(file.get(), 0, SEEK_END);
+    const std::uint64_t size = std::ftell(file.get());
+
+    // Slice s covers [bounds[s], bounds[s + 1]); inner bounds move forward to a line start
+    WorkerTeam team(num_threads);
+    const std::size_t num_slices =
+            std::max<std::uint64_t>(1, std::min<std::uint64_t>(team.Size(), size / kMinSliceBytes));
+    std::vector<std::uint64_t> bounds(num_slices + 1, size);
+    bounds[0] = 0;
+    for (std::size_t slice = 1; slice < num_slices; ++slice) {
+        std::uint64_t bound = std::max(bounds[slice - 1], size * slice / num_slices);
+        std::fseek(file.get(), bound - 1, SEEK_SET);
+        for (int ch = std::fgetc(file.get()); (ch != EOF) && (ch != '\n');
+             ch = std::fgetc(file.get())) {
+            ++bound;
+        }
+
+        bounds[slice] = std::min(bound, size);
+    }
+
+    EdgeListParser<DataT> parser(format);
+    std::vector<std::vector<WeightedEdge<DataT>>> sliced(num_slices);
+    auto parse_slice = [&](std::size_t slice, std::FILE* stream) {
+        std::vector<char> buffer;
+        std::uint64_t position = bounds[slice];
+        std::uint64_t carry_base = position;
+        std::fseek(stream, position, SEEK_SET);
+        while (position < bounds[slice + 1]) {
+            std::size_t carry = buffer.size();
+            std::size_t want = std::min<std::uint64_t>(kChunkBytes, bounds[slice + 1] - position);
+            buffer.resize(carry + want);
+            if (std::fread(buffer.data() + carry, 1, want, stream) != want) {
+                throw std::runtime_error("Cannot read " + path);
+            }
+
+            position += want;
+            std::size_t complete = buffer.size();
+            if (position < bounds[slice + 1]) {
+                while ((complete > 0) && (buffer[complete - 1] != '\n')) {
+                    --complete;
+                }
+            }
+
+            parser.Parse(buffer.data(), buffer.data() + complete, carry_base, sliced[slice]);
+            buffer.erase(buffer.begin(), buffer.begin() + complete);
+            carry_base += complete;
+        }
+    };
+
+    if (num_slices == 1) {
+        parse_slice(0, file.get());
+    } else {
+        team.ForEach(
+                0,
+                num_slices,
+                [&](unsigned, std::size_t lo, std::size_t hi) {
+                    auto stream = open();
+                    for (auto slice = lo; slice < hi; ++slice) {
+                        parse_slice(slice, stream.get());
+                    }
+                },
+                1);
+    }
+
+    std::vector<WeightedEdge<DataT>> edges = std::move(sliced[0]);
+    for (std::size_t slice = 1; slice < num_slices; ++slice) {
+        edges.insert(edges.end(), sliced[slice].begin(), sliced[slice].end());
+    }
+
+    return edges;
+}
+
+/// fn      ReadEdgeList
+/// \brief  Parses path and bulk-loads its edges into graph with AddEdges, so undirected graphs
+///         get both directions of every line; returns the number of lines that were edges
+template<typename DataT>
+std::size_t ReadEdgeList(
+        const std::string& path,
+        EdgeFormat format,
+        Graphis<DataT>& graph,
+        unsigned num_threads = 1) {
+    std::vector<WeightedEdge<DataT>> edges = ParseEdgeList<DataT>(path, format, num_threads);
+    graph.AddEdges(edges, num_threads);
+    return edges.size();
+}
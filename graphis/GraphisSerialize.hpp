@@ -0,0 +1,143 @@
+/*! -------------------------------------------------------------------------*\
+|   Binary stream helpers for persisting Graphis structures
+\*---------------------------------------------------------------------------*/
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// fn      WritePod
+template<typename PodT>
+void WritePod(std::ostream& out, const PodT& value) {
+    static_assert(std::is_trivially_copyable<PodT>::value, "WritePod needs a trivial type");
+    out.write(reinterpret_cast<const char*>(&value), sizeof(PodT));
+}
+
+/// fn      ReadPod
+template<typename PodT>
+PodT ReadPod(std::istream& in) {
+    static_assert(std::is_trivially_copyable<PodT>::value, "ReadPod needs a trivial type");
+    PodT value;
+    if (!in.read(reinterpret_cast<char*>(&value), sizeof(PodT))) {
+        throw std::runtime_error("Unexpected end of Graphis stream");
+    }
+
+    return value;
+}
+
+/// fn      WriteVector
+/// \brief  Writes the element count followed by the raw elements
+template<typename PodT>
+void WriteVector(std::ostream& out, const std::vector<PodT>& values) {
+    WritePod<std::uint64_t>(out, values.size());
+    out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(PodT));
+}
+
+/// fn      GetRemainingBytes
+/// \brief  Bytes left between the read position and the end of a seekable stream; the
+///         largest uint64_t if the stream cannot seek
+inline std::uint64_t GetRemainingBytes(std::istream& in) {
+    std::istream::pos_type here = in.tellg();
+    if (here == std::istream::pos_type(-1)) {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+
+    in.seekg(0, std::ios::end);
+    std::istream::pos_type end = in.tellg();
+    in.seekg(here);
+    if (!in.good() || (end == std::istream::pos_type(-1))) {
+        throw std::runtime_error("Cannot seek in Graphis stream");
+    }
+
+    return static_cast<std::uint64_t>(end - here);
+}
+
+/// fn      ReadVector
+/// \brief  Rejects an element count larger than what is left of the stream, and reads in
+///         bounded chunks so that a stream that cannot seek only allocates what it delivers
+template<typename PodT>
+std::vector<PodT> ReadVector(std::istream& in) {
+    constexpr std::uint64_t kChunkElements = (1 << 20) / sizeof(PodT) + 1;
+
+    std::uint64_t size = ReadPod<std::uint64_t>(in);
+    if (size > GetRemainingBytes(in) / sizeof(PodT)) {
+        throw std::runtime_error("Graphis stream is shorter than its vector sizes");
+    }
+
+    std::vector<PodT> values;
+    while (values.size() < size) {
+        std::size_t done = values.size();
+        values.resize(done + std::min<std::uint64_t>(kChunkElements, size - done));
+        std::size_t bytes = (values.size() - done) * sizeof(PodT);
+        if (!in.read(reinterpret_cast<char*>(values.data() + done), bytes)) {
+            throw std::runtime_error("Unexpected end of Graphis stream");
+        }
+    }
+
+    return values;
+}
+
+/// \struct KeyCodec
+/// \brief  Writes and reads vertex key tables; specialized for arithmetic keys and std::string
+template<typename DataT, typename Enable = void>
+struct KeyCodec;
+
+///
+template<typename DataT>
+struct KeyCodec<DataT, typename std::enable_if<std::is_arithmetic<DataT>::value>::type> {
+    ///
+    static std::vector<DataT> Read(std::istream& in) {
+        return ReadVector<DataT>(in);
+    }
+
+    ///
+    static void Write(std::ostream& out, const std::vector<DataT>& keys) {
+        WriteVector(out, keys);
+    }
+};
+
+/// \brief  Strings are stored as an offset table into one character blob
+template<>
+struct KeyCodec<std::string> {
+    ///
+    static std::vector<std::string> Read(std::istream& in) {
+        std::vector<std::uint64_t> offsets = ReadVector<std::uint64_t>(in);
+        std::vector<char> blob = ReadVector<char>(in);
+        bool valid = !offsets.empty() && (offsets.front() == 0) && (offsets.back() == blob.size());
+        for (std::size_t key = 0; valid && (key + 1 < offsets.size()); ++key) {
+            valid = offsets[key] <= offsets[key + 1];
+        }
+
+        if (!valid) {
+            throw std::runtime_error("Malformed Graphis key table");
+        }
+
+        std::vector<std::string> keys;
+        keys.reserve(offsets.empty() ? 0 : offsets.size() - 1);
+        for (std::size_t key = 0; key + 1 < offsets.size(); ++key) {
+            keys.emplace_back(blob.data() + offsets[key], offsets[key + 1] - offsets[key]);
+        }
+
+        return keys;
+    }
+
+    ///
+    static void Write(std::ostream& out, const std::vector<std::string>& keys) {
+        std::vector<std::uint64_t> offsets(1, 0);
+        std::vector<char> blob;
+        for (const auto& key : keys) {
+            blob.insert(blob.end(), key.begin(), key.end());
+            offsets.push_back(blob.size());
+        }
+
+        WriteVector(out, offsets);
+        WriteVector(out, blob);
+    }
+};
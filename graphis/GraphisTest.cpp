@@ -1,6 +1,21 @@
 #include "Graphis.hpp"
+#include "GraphisAnalytics.hpp"
+#include "GraphisCH.hpp"
+#include "GraphisCSR.hpp"
+#include "GraphisDynamic.hpp"
+#include "GraphisMapped.hpp"
+#include "GraphisReader.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <gmock/gmock.h>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
 #include <vector>
 
 /// \class  GraphisTest
@@ -82,8 +97,42 @@ public:
         allegiant.AddEdge("AZA", "SCK", 625);
     }
 
+    /// \brief  Unit-weight grid; vertex r * kGridSide + c sits at row r, column c
+    void LoadGrid() {
+        for (int row = 0; row < kGridSide; ++row) {
+            for (int col = 0; col < kGridSide; ++col) {
+                int vert = row * kGridSide + col;
+                if (col + 1 < kGridSide) {
+                    grid.AddEdge(vert, vert + 1, 1);
+                }
+
+                if (row + 1 < kGridSide) {
+                    grid.AddEdge(vert, vert + kGridSide, 1);
+                }
+            }
+        }
+    }
+
+    /// \brief  Reproducible random graph with a few high-degree hubs, to exercise both BFS
+    ///         directions
+    void LoadRandomGraph(Graphis<int>& graph, int num_vertices, int num_edges) {
+        std::mt19937 rng(20200518);
+        std::uniform_int_distribution<int> any(0, num_vertices - 1);
+        std::uniform_int_distribution<int> hub(0, 7);
+        std::uniform_int_distribution<int> weight(1, 100);
+        for (int edge = 0; edge < num_edges; ++edge) {
+            int src = (edge % 4 == 0) ? hub(rng) : any(rng);
+            graph.AddEdge(src, any(rng), weight(rng));
+        }
+    }
+
+    static constexpr int kGridSide = 16;
+
     Graphis<int> graph1;
     Graphis<int> graph2;
+    Graphis<int> grid;
+    Graphis<int> sparse;
+    Graphis<int> digraph{true};
     Graphis<std::string> allegiant;
     Graphis<char> dag;
     Graphis<char> adm;
@@ -224,6 +273,10 @@ void ProcessCycle(Graphis<DataT>& graph, DataT v1, DataT v2) {
 /// \brief  Implements ProcEdgeFn for depth first search when finding cycles
 template<typename DataT>
 void FindCycle(Graphis<DataT>& graph, DataT v1, DataT v2) {
+    if (graph.GetEdgeClassification(v1, v2) == EdgeClassification::EC_TREE) {
+        return;
+    }
+
     if (v1 == v2) {
         ProcessCycle(graph, v1, v2);
     }
@@ -255,25 +308,17 @@ template<typename DataT>
 void ClassifyEdges(Graphis<DataT>& graph, DataT v1, DataT v2) {
     EdgeClassification eclass = graph.GetEdgeClassification(v1, v2);
 
-    if (eclass == EC_BACK_EDGE) {
+    if (eclass == EdgeClassification::EC_BACK_EDGE) {
         std::cerr << "WARNING: Directed cycle found, not a DAG" << std::endl;
     }
 }
 
-///
-/// \brief  Implements SetProcessVertexLate for DFS when performing topo sort
-template<typename DataT>
-void PushSorted(Graphis<DataT>& graph, DataT vertex) {
-    graph.PushSorted(vertex);
-}
-
 /// \test   TopoSortShouldMatchExpectedTopology
 TEST_F(GraphisTest, TopoSortShouldMatchExpectedTopology) {
     LoadDAG();
     std::vector<char> expected{'G', 'A', 'B', 'C', 'F', 'E', 'D'};
 
     dag.SetProcessEdgeFn(ClassifyEdges);
-    dag.SetProcessVertexLate(PushSorted);
     std::vector<char> sorted = dag.TopologicalSort();
     EXPECT_THAT(expected, ::testing::Eq(sorted));
 }
@@ -296,6 +341,1374 @@ TEST_F(GraphisTest, DjikstraShortestPathShouldYieldShortest) {
     EXPECT_THAT(expected, ::testing::Eq(span));
 }
 
+/// \test   InternedVerticesShouldReportKeysInOrder
+TEST_F(GraphisTest, InternedVerticesShouldReportKeysInOrder) {
+    LoadRouteGraph();
+
+    std::vector<std::string> verts = allegiant.GetVertexList();
+    EXPECT_EQ(14, verts.size());
+    EXPECT_TRUE(std::is_sorted(verts.begin(), verts.end()));
+    EXPECT_TRUE(allegiant.GetAdjacentVertices("SFO").empty());
+
+    std::vector<std::string> bfsout = allegiant.BreadthFirstSearch("LAX");
+    ParentList<std::string> parents = allegiant.GetParents();
+    EXPECT_EQ(13, parents.size());
+    EXPECT_EQ(parents.end(), parents.find("LAX"));
+    EXPECT_EQ("LAX", parents.at("RNO"));
+    EXPECT_EQ("AZA", parents.at("LAS"));
+}
+
+/// \test   FrozenGraphShouldMatchAdjacencyLists
+TEST_F(GraphisTest, FrozenGraphShouldMatchAdjacencyLists) {
+    LoadGeekGraph();
+    GraphisCSR<int> frozen = graph1.Freeze();
+
+    EXPECT_EQ(graph1.GetNumEdges(), frozen.GetNumEdges());
+    EXPECT_THAT(graph1.GetVertexList(), ::testing::Eq(frozen.GetVertexList()));
+
+    for (auto vert : frozen.GetVertexList()) {
+        VertexId id = frozen.FindId(vert);
+        std::vector<int> adjacent;
+        for (auto edge = frozen.GetOffsets()[id]; edge < frozen.GetOffsets()[id + 1]; ++edge) {
+            adjacent.push_back(frozen.GetKey(frozen.GetTargets()[edge]));
+        }
+
+        EXPECT_THAT(graph1.GetAdjacentVertices(vert), ::testing::Eq(adjacent));
+    }
+
+    EXPECT_EQ(kNoVertex, frozen.FindId(42));
+}
+
+/// \test   FrozenSearchesShouldMatchGraphis
+TEST_F(GraphisTest, FrozenSearchesShouldMatchGraphis) {
+    LoadSearchGraph();
+    GraphisCSR<int> frozen = graph2.Freeze();
+
+    EXPECT_THAT(graph2.BreadthFirstSearch(1), ::testing::Eq(frozen.BreadthFirstSearch(1)));
+    EXPECT_THAT(graph2.DepthFirstSearch(2), ::testing::Eq(frozen.DepthFirstSearch(2)));
+
+    LoadRouteGraph();
+    GraphisCSR<std::string> routes = allegiant.Freeze();
+    EXPECT_THAT(allegiant.ConnectedComponents(), ::testing::Eq(routes.ConnectedComponents()));
+}
+
+/// \test   FrozenTopoSortShouldMatchExpectedTopology
+TEST_F(GraphisTest, FrozenTopoSortShouldMatchExpectedTopology) {
+    LoadDAG();
+    std::vector<char> expected{'G', 'A', 'B', 'C', 'F', 'E', 'D'};
+
+    EXPECT_THAT(expected, ::testing::Eq(dag.Freeze().TopologicalSort()));
+}
+
+/// \test   FrozenSpanningSearchesShouldMatchGraphis
+TEST_F(GraphisTest, FrozenSpanningSearchesShouldMatchGraphis) {
+    LoadADM();
+    GraphisCSR<char> frozen = adm.Freeze();
+
+    std::vector<char> prim{'A', 'B', 'C', 'F', 'G', 'D', 'E'};
+    EXPECT_THAT(prim, ::testing::Eq(frozen.PrimSpanningTree('A')));
+
+    ParentList<char> parents;
+    std::vector<char> djikstra{'A', 'B', 'D', 'F', 'C', 'E', 'G'};
+    EXPECT_THAT(djikstra, ::testing::Eq(frozen.DjikstaShortestPath('A', &parents)));
+    EXPECT_EQ('D', parents.at('F'));
+    EXPECT_EQ('F', parents.at('G'));
+}
+
+/// \test   SpanningSearchesShouldRejectUnknownRoot
+TEST_F(GraphisTest, SpanningSearchesShouldRejectUnknownRoot) {
+    LoadADM();
+    GraphisCSR<char> frozen = adm.Freeze();
+
+    EXPECT_THROW(adm.DjikstaShortestPath('Z'), std::out_of_range);
+    EXPECT_THROW(adm.DjikstaShortestPath('Z', QueueKind::QK_RADIX_HEAP), std::out_of_range);
+    EXPECT_THROW(adm.PrimSpanningTree('Z'), std::out_of_range);
+    EXPECT_THROW(frozen.DjikstaShortestPath('Z'), std::out_of_range);
+    EXPECT_THROW(frozen.PrimSpanningTree('Z'), std::out_of_range);
+}
+
+/// \test   IndexedHeapShouldPopInKeyOrder
+TEST_F(GraphisTest, IndexedHeapShouldPopInKeyOrder) {
+    IndexedHeap<int> heap(5);
+    heap.Push(0, 40);
+    heap.Push(1, 10);
+    heap.Push(2, 30);
+    heap.Push(3, 10);
+    heap.Push(2, 5);
+    heap.Push(1, 50);
+
+    std::vector<std::uint32_t> expected{2, 1, 3, 0};
+    std::vector<std::uint32_t> popped;
+    while (!heap.IsEmpty()) {
+        popped.push_back(heap.PopMin());
+    }
+
+    EXPECT_THAT(expected, ::testing::Eq(popped));
+    EXPECT_EQ(5, heap.GetKey(2));
+}
+
+/// \test   RadixHeapShouldPopMonotoneKeys
+TEST_F(GraphisTest, RadixHeapShouldPopMonotoneKeys) {
+    RadixHeap heap;
+    heap.Push(0, 7);
+    heap.Push(1, 3);
+    heap.Push(2, 1024);
+    heap.Push(3, 3);
+
+    EXPECT_EQ(3, heap.PopMin().first);
+    heap.Push(4, 5);
+    EXPECT_EQ(3, heap.PopMin().first);
+    EXPECT_EQ(5, heap.PopMin().first);
+    EXPECT_EQ(7, heap.PopMin().first);
+    EXPECT_THROW(heap.Push(5, 6), std::invalid_argument);
+    EXPECT_EQ(2, heap.PopMin().second);
+    EXPECT_TRUE(heap.IsEmpty());
+}
+
+/// \test   RadixDjikstraShouldMatchBinaryHeap
+TEST_F(GraphisTest, RadixDjikstraShouldMatchBinaryHeap) {
+    LoadRouteGraph();
+
+    std::vector<std::string> binary = allegiant.DjikstaShortestPath("LAX");
+    std::stack<std::string> binary_path;
+    allegiant.FindPath("LAX", "SCK", binary_path);
+
+    std::vector<std::string> radix =
+            allegiant.DjikstaShortestPath("LAX", QueueKind::QK_RADIX_HEAP);
+    std::stack<std::string> radix_path;
+    allegiant.FindPath("LAX", "SCK", radix_path);
+
+    EXPECT_THAT(binary, ::testing::UnorderedElementsAreArray(radix));
+    EXPECT_EQ(binary_path, radix_path);
+    EXPECT_EQ(4, radix_path.size());
+}
+
+/// \test   ShortestPathShouldStopAtDestination
+TEST_F(GraphisTest, ShortestPathShouldStopAtDestination) {
+    LoadADM();
+
+    PathResult<char> result = adm.ShortestPath('A', 'F');
+    std::vector<char> expected{'A', 'D', 'F'};
+    EXPECT_THAT(expected, ::testing::Eq(result.path));
+    EXPECT_EQ(10, result.distance);
+    EXPECT_EQ(4, result.settled);
+
+    PathResult<char> self = adm.ShortestPath('C', 'C');
+    EXPECT_EQ(0, self.distance);
+    EXPECT_EQ(1, self.path.size());
+
+    PathResult<char> missing = adm.ShortestPath('A', 'Z');
+    EXPECT_EQ(kUnreachable, missing.distance);
+    EXPECT_TRUE(missing.path.empty());
+}
+
+/// \test   BidirectionalShortestPathShouldMatchDjikstra
+TEST_F(GraphisTest, BidirectionalShortestPathShouldMatchDjikstra) {
+    LoadRouteGraph();
+
+    std::vector<std::string> verts = allegiant.GetVertexList();
+    for (const auto& src : verts) {
+        for (const auto& dst : verts) {
+            PathResult<std::string> oneway = allegiant.ShortestPath(src, dst);
+            PathResult<std::string> twoway = allegiant.BidirectionalShortestPath(src, dst);
+            EXPECT_EQ(oneway.distance, twoway.distance);
+            ASSERT_FALSE(twoway.path.empty());
+            EXPECT_EQ(src, twoway.path.front());
+            EXPECT_EQ(dst, twoway.path.back());
+        }
+    }
+
+    PathResult<std::string> route = allegiant.BidirectionalShortestPath("LAX", "SCK");
+    std::vector<std::string> expected{"LAX", "IDA", "AZA", "SCK"};
+    EXPECT_THAT(expected, ::testing::Eq(route.path));
+    EXPECT_EQ(743 + 704 + 625, route.distance);
+}
+
+/// \test   AStarShouldMatchDjikstraAndSettleFewer
+TEST_F(GraphisTest, AStarShouldMatchDjikstraAndSettleFewer) {
+    LoadGrid();
+    const int goal = 5 * kGridSide + 9;
+    auto manhattan = [goal](int vert) {
+        return std::abs(vert / kGridSide - goal / kGridSide)
+               + std::abs(vert % kGridSide - goal % kGridSide);
+    };
+
+    PathResult<int> djikstra = grid.ShortestPath(0, goal);
+    PathResult<int> astar = grid.AStarShortestPath(0, goal, manhattan);
+    EXPECT_EQ(14, djikstra.distance);
+    EXPECT_EQ(djikstra.distance, astar.distance);
+    EXPECT_EQ(15, astar.path.size());
+    EXPECT_LT(astar.settled, djikstra.settled);
+
+    LoadRouteGraph();
+    PathResult<std::string> zero =
+            allegiant.AStarShortestPath("BOI", "SCK", [](const std::string&) { return 0; });
+    PathResult<std::string> plain = allegiant.ShortestPath("BOI", "SCK");
+    EXPECT_THAT(plain.path, ::testing::Eq(zero.path));
+    EXPECT_EQ(plain.settled, zero.settled);
+}
+
+/// \brief  Checks every pair of vertices against the plain Dijkstra point-to-point query
+template<typename DataT>
+void ExpectHierarchyMatches(Graphis<DataT>& graph, const ContractionHierarchy<DataT>& ch) {
+    typename ContractionHierarchy<DataT>::Workspace workspace(ch);
+    std::vector<DataT> verts = graph.GetVertexList();
+    for (const auto& src : verts) {
+        for (const auto& dst : verts) {
+            PathResult<DataT> expected = graph.ShortestPath(src, dst);
+            PathResult<DataT> actual = ch.ShortestPath(src, dst, workspace);
+            ASSERT_EQ(expected.distance, actual.distance) << src << " -> " << dst;
+            if (expected.distance == kUnreachable) {
+                EXPECT_TRUE(actual.path.empty());
+                continue;
+            }
+
+            // Paths may differ on ties, so check the unpacked path really has that length
+            int length = 0;
+            for (std::size_t hop = 0; hop + 1 < actual.path.size(); ++hop) {
+                int weight = kUnreachable;
+                for (const auto& adj : graph.GetAdjacencyList(actual.path[hop])) {
+                    if (adj.dest == actual.path[hop + 1]) {
+                        weight = std::min(weight, adj.weight);
+                    }
+                }
+
+                ASSERT_NE(kUnreachable, weight);
+                length += weight;
+            }
+
+            EXPECT_EQ(expected.distance, length);
+            EXPECT_EQ(src, actual.path.front());
+            EXPECT_EQ(dst, actual.path.back());
+        }
+    }
+}
+
+/// \test   ContractionHierarchyShouldMatchDjikstra
+TEST_F(GraphisTest, ContractionHierarchyShouldMatchDjikstra) {
+    LoadADM();
+    ExpectHierarchyMatches(adm, ContractionHierarchy<char>(adm));
+
+    LoadRouteGraph();
+    ExpectHierarchyMatches(allegiant, ContractionHierarchy<std::string>(allegiant));
+
+    LoadGrid();
+    ContractionHierarchy<int> gridch(grid);
+    EXPECT_GT(gridch.GetNumShortcuts(), 0);
+    ExpectHierarchyMatches(grid, gridch);
+
+    LoadSearchGraph();
+    ExpectHierarchyMatches(graph2, ContractionHierarchy<int>(graph2));
+}
+
+/// \test   ContractionHierarchyShouldRoundTripThroughStream
+TEST_F(GraphisTest, ContractionHierarchyShouldRoundTripThroughStream) {
+    LoadRouteGraph();
+    ContractionHierarchy<std::string> built(allegiant);
+
+    std::stringstream stream;
+    built.Save(stream);
+    ContractionHierarchy<std::string> loaded = ContractionHierarchy<std::string>::Load(stream);
+
+    EXPECT_EQ(built.GetNumVerts(), loaded.GetNumVerts());
+    EXPECT_EQ(built.GetNumShortcuts(), loaded.GetNumShortcuts());
+    ExpectHierarchyMatches(allegiant, loaded);
+
+    std::stringstream garbage("not a hierarchy");
+    EXPECT_THROW(ContractionHierarchy<std::string>::Load(garbage), std::runtime_error);
+
+    std::string saved = stream.str();
+    std::stringstream truncated(saved.substr(0, saved.size() / 2));
+    EXPECT_THROW(ContractionHierarchy<std::string>::Load(truncated), std::runtime_error);
+
+    // A key table claiming 2^40 offsets fails before allocating them
+    std::stringstream oversized;
+    oversized.write(saved.data(), 9);
+    WritePod<std::uint64_t>(oversized, std::uint64_t(1) << 40);
+    EXPECT_THROW(ContractionHierarchy<std::string>::Load(oversized), std::runtime_error);
+}
+
+/// \test   ContractionHierarchyShouldRejectCorruptArcsAndRanks
+TEST_F(GraphisTest, ContractionHierarchyShouldRejectCorruptArcsAndRanks) {
+    LoadSearchGraph();
+    ContractionHierarchy<int> built(graph2);
+    ASSERT_GT(built.GetNumVerts(), 0);
+    std::stringstream stream;
+    built.Save(stream);
+    std::string saved = stream.str();
+
+    // Header, then keys, ranks and forward offsets ahead of the first forward arc
+    const std::size_t num_verts = built.GetNumVerts();
+    std::size_t first_arc = 9 + (8 + num_verts * sizeof(int)) + (8 + num_verts * sizeof(VertexId))
+                            + (8 + (num_verts + 1) * sizeof(EdgeOffset)) + 8;
+    ASSERT_LT(first_arc + sizeof(VertexId), saved.size());
+    auto corrupt_load = [&](std::size_t offset, VertexId bogus) {
+        std::string corrupted = saved;
+        corrupted.replace(
+                offset, sizeof(bogus), reinterpret_cast<const char*>(&bogus), sizeof(bogus));
+        std::stringstream corrupt(corrupted);
+        EXPECT_THROW(ContractionHierarchy<int>::Load(corrupt), std::runtime_error) << bogus;
+    };
+
+    corrupt_load(first_arc, 1000);
+
+    // A middle equal to the arc's head would make unpacking loop forever
+    VertexId head;
+    std::memcpy(&head, saved.data() + first_arc, sizeof(head));
+    corrupt_load(first_arc + offsetof(HierarchyArc, middle), head);
+
+    // Duplicate ranks: the second vertex takes the first one's rank
+    std::size_t first_rank = 9 + (8 + num_verts * sizeof(int)) + 8;
+    VertexId rank;
+    std::memcpy(&rank, saved.data() + first_rank, sizeof(rank));
+    corrupt_load(first_rank + sizeof(VertexId), rank);
+}
+
+/// \brief  Checks a parallel BFS against the serial one: same vertex set, and every parent
+///         is an in-neighbor exactly one hop closer to the root
+template<typename DataT>
+void ExpectValidParallelBreadthFirst(const GraphisCSR<DataT>& frozen, const DataT& root) {
+    std::vector<DataT> serial = frozen.BreadthFirstSearch(root);
+    ParentList<DataT> parents;
+    std::vector<DataT> parallel = frozen.ParallelBreadthFirstSearch(root, &parents, 4);
+    EXPECT_THAT(parallel, ::testing::UnorderedElementsAreArray(serial));
+    EXPECT_EQ(root, parallel.front());
+    EXPECT_EQ(serial.size() - 1, parents.size());
+
+    std::map<DataT, int> hops;
+    hops[root] = 0;
+    for (const auto& vert : parallel) {
+        if (vert == root) {
+            continue;
+        }
+
+        const DataT& parent = parents.at(vert);
+        ASSERT_EQ(1, hops.count(parent));
+        hops[vert] = hops[parent] + 1;
+
+        VertexId src = frozen.FindId(parent);
+        const auto& targets = frozen.GetTargets();
+        auto first = targets.begin() + frozen.GetOffsets()[src];
+        auto last = targets.begin() + frozen.GetOffsets()[src + 1];
+        EXPECT_NE(last, std::find(first, last, frozen.FindId(vert)));
+    }
+
+    for (std::size_t level = 1; level < parallel.size(); ++level) {
+        EXPECT_LE(hops[parallel[level - 1]], hops[parallel[level]]);
+    }
+}
+
+/// \test   ParallelBreadthFirstSearchShouldMatchSerial
+TEST_F(GraphisTest, ParallelBreadthFirstSearchShouldMatchSerial) {
+    LoadSearchGraph();
+    ExpectValidParallelBreadthFirst(graph2.Freeze(), 1);
+
+    LoadRouteGraph();
+    ExpectValidParallelBreadthFirst(allegiant.Freeze(), std::string("LAX"));
+
+    LoadRandomGraph(sparse, 2000, 12000);
+    ExpectValidParallelBreadthFirst(sparse.Freeze(), 0);
+
+    LoadRandomGraph(digraph, 2000, 12000);
+    GraphisCSR<int> frozen = digraph.Freeze();
+    EXPECT_EQ(frozen.GetNumEdges(), frozen.GetInSources().size());
+    ExpectValidParallelBreadthFirst(frozen, 3);
+}
+
+/// Classifications seen by RecordEdgeClassification, in hook order
+std::vector<EdgeClassification> g_classifications;
+
+///
+/// \brief  Implements ProcEdgeFn for depth first search when recording edge classes
+template<typename DataT>
+void RecordEdgeClassification(Graphis<DataT>& graph, DataT v1, DataT v2) {
+    g_classifications.push_back(graph.GetEdgeClassification(v1, v2));
+}
+
+/// \test   DepthFirstSearchShouldClassifyEdgesWithGlobalTimes
+TEST_F(GraphisTest, DepthFirstSearchShouldClassifyEdgesWithGlobalTimes) {
+    LoadSearchGraph();
+    g_classifications.clear();
+    graph2.SetProcessEdgeFn(RecordEdgeClassification);
+
+    std::vector<int> expected{0, 2, 3, 1};
+    EXPECT_THAT(expected, ::testing::Eq(graph2.DepthFirstSearch(0)));
+
+    std::vector<EdgeClassification> classes{EdgeClassification::EC_TREE,
+                                            EdgeClassification::EC_TREE,
+                                            EdgeClassification::EC_BACK_EDGE,
+                                            EdgeClassification::EC_BACK_EDGE,
+                                            EdgeClassification::EC_TREE,
+                                            EdgeClassification::EC_CROSS_EDGE};
+    EXPECT_THAT(classes, ::testing::Eq(g_classifications));
+
+    EntryList<int> times = graph2.GetEntryTimes();
+    EXPECT_EQ(std::make_pair(1, 8), times.at(0));
+    EXPECT_EQ(std::make_pair(2, 5), times.at(2));
+    EXPECT_EQ(std::make_pair(3, 4), times.at(3));
+    EXPECT_EQ(std::make_pair(6, 7), times.at(1));
+
+    ParentList<int> parents = graph2.GetParents();
+    EXPECT_EQ(0, parents.at(2));
+    EXPECT_EQ(2, parents.at(3));
+    EXPECT_EQ(0, parents.at(1));
+}
+
+/// \test   DepthFirstSearchShouldSurviveLongChains
+TEST_F(GraphisTest, DepthFirstSearchShouldSurviveLongChains) {
+    const int length = 200000;
+    Graphis<int> chain(true);
+    for (int vert = 0; vert + 1 < length; ++vert) {
+        chain.AddEdge(vert, vert + 1);
+    }
+
+    std::vector<int> dfs = chain.DepthFirstSearch(0);
+    ASSERT_EQ(length, dfs.size());
+    EXPECT_EQ(length - 1, dfs.back());
+    EXPECT_EQ(std::make_pair(1, 2 * length), chain.GetEntryTimes().at(0));
+
+    std::vector<int> sorted = chain.TopologicalSort();
+    EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end()));
+}
+
+/// \test   NeighborsShouldMatchAdjacencyList
+TEST_F(GraphisTest, NeighborsShouldMatchAdjacencyList) {
+    LoadRouteGraph();
+    for (const auto& vert : allegiant.GetVertexList()) {
+        AdjacencyList<std::string> adjlist = allegiant.GetAdjacencyList(vert);
+        ASSERT_EQ(adjlist.size(), allegiant.GetNeighbors(vert).size());
+
+        auto expected = adjlist.begin();
+        for (const auto& neighbor : allegiant.GetNeighbors(vert)) {
+            EXPECT_EQ(expected->dest, neighbor.dest);
+            EXPECT_EQ(expected->weight, neighbor.weight);
+            ++expected;
+        }
+    }
+
+    EXPECT_TRUE(allegiant.GetNeighbors("SFO").empty());
+}
+
+/// \test   ConnectedComponentsShouldVisitEachVertexOnce
+TEST_F(GraphisTest, ConnectedComponentsShouldVisitEachVertexOnce) {
+    const int num_pairs = 500;
+    for (int pair = num_pairs - 1; pair >= 0; --pair) {
+        graph1.AddEdge(2 * pair + 1, 2 * pair);
+    }
+
+    ComponentList<int> components = graph1.ConnectedComponents();
+    ASSERT_EQ(num_pairs, components.size());
+    for (const auto& component : components) {
+        int first = 2 * (component.first - 1);
+        EXPECT_THAT(component.second, ::testing::UnorderedElementsAre(first, first + 1));
+    }
+}
+
+/// \test   ParallelConnectedComponentsShouldMatchSerial
+TEST_F(GraphisTest, ParallelConnectedComponentsShouldMatchSerial) {
+    LoadRandomGraph(sparse, 6000, 4000);
+    GraphisCSR<int> frozen = sparse.Freeze();
+
+    ComponentList<int> expected = frozen.ConnectedComponents();
+    for (auto& component : expected) {
+        std::sort(component.second.begin(), component.second.end());
+    }
+
+    ASSERT_LT(100, expected.size());
+    for (auto kind : {ComponentKind::CK_UNION_FIND, ComponentKind::CK_AFFOREST}) {
+        for (unsigned num_threads : {1u, 4u}) {
+            EXPECT_THAT(
+                    frozen.ParallelConnectedComponents(kind, num_threads), ::testing::Eq(expected));
+        }
+    }
+
+    LoadRandomGraph(digraph, 6000, 4000);
+    EXPECT_THAT(digraph.Freeze().ParallelConnectedComponents(), ::testing::Eq(expected));
+}
+
+/// \test   MinimumSpanningTreeShouldReportEdgesAndWeight
+TEST_F(GraphisTest, MinimumSpanningTreeShouldReportEdgesAndWeight) {
+    LoadADM();
+    SpanningTree<char> tree = adm.Freeze().MinimumSpanningTree();
+
+    std::vector<WeightedEdge<char>> expected{{'A', 'B', 5},
+                                             {'A', 'D', 7},
+                                             {'D', 'F', 3},
+                                             {'C', 'F', 2},
+                                             {'F', 'G', 2},
+                                             {'D', 'E', 4}};
+    EXPECT_THAT(tree.edges, ::testing::Eq(expected));
+    EXPECT_EQ(23, tree.weight);
+
+    LoadDAG();
+    EXPECT_THROW(dag.Freeze().MinimumSpanningTree(), std::invalid_argument);
+}
+
+/// \test   MinimumSpanningTreeEnginesShouldAgree
+TEST_F(GraphisTest, MinimumSpanningTreeEnginesShouldAgree) {
+    LoadRandomGraph(sparse, 3000, 5000);
+    GraphisCSR<int> frozen = sparse.Freeze();
+
+    SpanningTree<int> kruskal = frozen.MinimumSpanningTree(SpanningKind::SK_KRUSKAL);
+    std::size_t num_components = frozen.ConnectedComponents().size();
+    EXPECT_EQ(frozen.GetNumVerts() - num_components, kruskal.edges.size());
+
+    auto expect_same_forest = [&](const SpanningTree<int>& tree) {
+        EXPECT_EQ(kruskal.weight, tree.weight);
+        EXPECT_THAT(tree.edges, ::testing::UnorderedElementsAreArray(kruskal.edges));
+    };
+
+    expect_same_forest(frozen.MinimumSpanningTree(SpanningKind::SK_PRIM));
+    expect_same_forest(frozen.MinimumSpanningTree(SpanningKind::SK_BORUVKA, 1));
+    expect_same_forest(frozen.MinimumSpanningTree(SpanningKind::SK_BORUVKA, 4));
+}
+
+/// \test   AddEdgesShouldMatchAddEdge
+TEST_F(GraphisTest, AddEdgesShouldMatchAddEdge) {
+    std::mt19937 rng(20200518);
+    std::uniform_int_distribution<int> any(0, 499);
+    std::uniform_int_distribution<int> weight(1, 100);
+    std::vector<WeightedEdge<int>> edges;
+    for (int edge = 0; edge < 5000; ++edge) {
+        edges.push_back(WeightedEdge<int>{any(rng), any(rng), weight(rng)});
+    }
+
+    for (bool is_directed : {false, true}) {
+        for (unsigned num_threads : {1u, 4u}) {
+            Graphis<int> expected(is_directed);
+            Graphis<int> bulk(is_directed);
+            for (const auto& edge : edges) {
+                expected.AddEdge(edge.src, edge.dst, edge.weight);
+            }
+
+            // Extending a graph that already has edges must append after them
+            std::vector<WeightedEdge<int>> head(edges.begin(), edges.begin() + 100);
+            std::vector<WeightedEdge<int>> tail(edges.begin() + 100, edges.end());
+            bulk.AddEdges(head);
+            bulk.AddEdges(tail, num_threads);
+
+            EXPECT_EQ(expected.GetNumEdges(), bulk.GetNumEdges());
+            EXPECT_EQ(expected.GetNumVerts(), bulk.GetNumVerts());
+            for (auto vert : expected.GetVertexList()) {
+                std::vector<std::pair<int, int>> want;
+                for (const auto& neighbor : expected.GetNeighbors(vert)) {
+                    want.emplace_back(neighbor.dest, neighbor.weight);
+                }
+
+                std::vector<std::pair<int, int>> got;
+                for (const auto& neighbor : bulk.GetNeighbors(vert)) {
+                    got.emplace_back(neighbor.dest, neighbor.weight);
+                }
+
+                ASSERT_THAT(got, ::testing::Eq(want));
+            }
+
+            EXPECT_THAT(bulk.GetVertexList(), ::testing::Eq(expected.GetVertexList()));
+            EXPECT_THAT(bulk.BreadthFirstSearch(0), ::testing::Eq(expected.BreadthFirstSearch(0)));
+        }
+    }
+}
+
+/// \test   MappedGraphShouldMatchFrozenGraph
+TEST_F(GraphisTest, MappedGraphShouldMatchFrozenGraph) {
+    LoadRouteGraph();
+    const std::string routes_path = testing::TempDir() + "graphis_routes.grmf";
+    {
+        std::ofstream out(routes_path, std::ios::binary);
+        MappedGraphis<std::string>::Save(allegiant, out);
+    }
+
+    GraphisCSR<std::string> frozen = allegiant.Freeze();
+    MappedGraphis<std::string> routes = MappedGraphis<std::string>::Open(routes_path);
+    ASSERT_EQ(frozen.GetNumVerts(), routes.GetNumVerts());
+    ASSERT_EQ(frozen.GetNumEdges(), routes.GetNumEdges());
+    EXPECT_FALSE(routes.IsDirected());
+    for (const auto& vert : frozen.GetVertexList()) {
+        EXPECT_EQ(frozen.FindId(vert), routes.FindId(vert));
+        EXPECT_EQ(vert, routes.GetKey(routes.FindId(vert)));
+    }
+
+    EXPECT_EQ(kNoVertex, routes.FindId("SFO"));
+    EXPECT_THAT(routes.GetTargets(), ::testing::ElementsAreArray(frozen.GetTargets()));
+    EXPECT_THAT(routes.GetWeights(), ::testing::ElementsAreArray(frozen.GetWeights()));
+    EXPECT_THAT(routes.BreadthFirstSearch("LAX"),
+                ::testing::Eq(frozen.BreadthFirstSearch("LAX")));
+
+    LoadRandomGraph(digraph, 2000, 12000);
+    const std::string random_path = testing::TempDir() + "graphis_random.grmf";
+    {
+        std::ofstream out(random_path, std::ios::binary);
+        MappedGraphis<int>::Save(digraph, out);
+    }
+
+    MappedGraphis<int> mapped = MappedGraphis<int>::Open(random_path);
+    EXPECT_TRUE(mapped.IsDirected());
+    for (int dst : {1, 17, 999, 1999}) {
+        PathResult<int> expected = digraph.ShortestPath(0, dst);
+        PathResult<int> actual = mapped.ShortestPath(0, dst);
+        EXPECT_EQ(expected.distance, actual.distance);
+        EXPECT_EQ(expected.path.size(), actual.path.size());
+    }
+
+    EXPECT_THROW(MappedGraphis<std::string>::Open(random_path), std::runtime_error);
+    EXPECT_THROW(MappedGraphis<int>::Open(routes_path), std::runtime_error);
+
+    std::ifstream in(random_path, std::ios::binary);
+    std::string truncated((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    truncated.resize(truncated.size() / 2);
+    std::ofstream(random_path, std::ios::binary) << truncated;
+    EXPECT_THROW(MappedGraphis<int>::Open(random_path), std::runtime_error);
+
+    std::remove(routes_path.c_str());
+    std::remove(random_path.c_str());
+}
+
+/// \test   EdgeListReaderShouldParseDimacsAndSnap
+TEST_F(GraphisTest, EdgeListReaderShouldParseDimacsAndSnap) {
+    const std::string path = testing::TempDir() + "graphis_edges.txt";
+    std::ofstream(path, std::ios::binary) << "c 9th DIMACS challenge sample\n"
+                                             "p sp 4 4\n"
+                                             "a 1 2 7\r\n"
+                                             "\n"
+                                             "a 2 3 -4\n"
+                                             "  a\t3 4 12\n"
+                                             "a 4 1 1";
+
+    ReadEdgeList(path, EdgeFormat::EF_DIMACS, digraph);
+    EXPECT_EQ(4, digraph.GetNumEdges());
+    EXPECT_THAT(digraph.GetAdjacentVertices(4), ::testing::ElementsAre(1));
+    std::vector<WeightedEdge<int>> dimacs{{1, 2, 7}, {2, 3, -4}, {3, 4, 12}, {4, 1, 1}};
+    EXPECT_THAT(ParseEdgeList<int>(path, EdgeFormat::EF_DIMACS), ::testing::Eq(dimacs));
+
+    std::ofstream(path, std::ios::binary) << "# Directed graph: sample.txt\n"
+                                             "# FromNodeId\tToNodeId\n"
+                                             "0\t1\n"
+                                             "1\t2\t5\n";
+    std::vector<WeightedEdge<long>> snap{{0, 1, 0}, {1, 2, 5}};
+    EXPECT_THAT(ParseEdgeList<long>(path, EdgeFormat::EF_SNAP), ::testing::Eq(snap));
+
+    std::ofstream(path, std::ios::binary) << "a 1 2 7\na 1 x 3\n";
+    EXPECT_THROW(ParseEdgeList<int>(path, EdgeFormat::EF_DIMACS), std::runtime_error);
+
+    // Fields must be separated by blanks and must fit the vertex and weight types
+    for (const char* line : {"a1 2 3\n", "a 1 2-3\n", "a 1 2 3000000000\n",
+                             "a 1 99999999999999999999 3\n"}) {
+        std::ofstream(path, std::ios::binary) << line;
+        EXPECT_THROW(ParseEdgeList<int>(path, EdgeFormat::EF_DIMACS), std::runtime_error) << line;
+    }
+
+    for (const char* line : {"1-2\n", "-1 2\n", "1 4294967296\n"}) {
+        std::ofstream(path, std::ios::binary) << line;
+        EXPECT_THROW(ParseEdgeList<unsigned>(path, EdgeFormat::EF_SNAP), std::runtime_error)
+                << line;
+    }
+
+    std::ofstream(path, std::ios::binary) << "-1 2\n";
+    std::vector<WeightedEdge<long>> negative{{-1, 2, 0}};
+    EXPECT_THAT(ParseEdgeList<long>(path, EdgeFormat::EF_SNAP), ::testing::Eq(negative));
+
+    // Large enough for several slices and several chunks per slice
+    std::mt19937 rng(20200518);
+    std::uniform_int_distribution<int> any(0, 99999);
+    std::vector<WeightedEdge<int>> expected;
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "p sp 100000 150000\n";
+        for (int edge = 0; edge < 150000; ++edge) {
+            expected.push_back(WeightedEdge<int>{any(rng), any(rng), any(rng) % 1000});
+            out << "a " << expected.back().src << ' ' << expected.back().dst << ' '
+                << expected.back().weight << '\n';
+        }
+    }
+
+    for (unsigned num_threads : {1u, 3u, 4u}) {
+        EXPECT_THAT(ParseEdgeList<int>(path, EdgeFormat::EF_DIMACS, num_threads),
+                    ::testing::Eq(expected));
+    }
+
+    // A bad line in any slice reaches the caller, whichever worker parsed it
+    for (std::size_t bad_line : {std::size_t{10}, expected.size() / 2, expected.size() - 10}) {
+        {
+            std::ofstream out(path, std::ios::binary);
+            for (std::size_t edge = 0; edge < expected.size(); ++edge) {
+                out << ((edge == bad_line) ? "a 1 x 3\n" : "a 1 2 3\n");
+            }
+        }
+
+        for (unsigned num_threads : {1u, 3u, 4u}) {
+            EXPECT_THROW(ParseEdgeList<int>(path, EdgeFormat::EF_DIMACS, num_threads),
+                         std::runtime_error);
+        }
+    }
+
+    EXPECT_THROW(ParseEdgeList<int>(path + ".missing", EdgeFormat::EF_SNAP), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+/// \test   ConcurrentQueriesShouldMatchSerial
+TEST_F(GraphisTest, ConcurrentQueriesShouldMatchSerial) {
+    LoadRandomGraph(digraph, 2000, 12000);
+    const std::vector<int> roots{0, 3, 7, 11, 42, 1999};
+
+    struct Answer {
+        std::vector<int> bfs;
+        std::vector<int> dfs;
+        std::vector<int> dijkstra;
+        ParentList<int> parents;
+        EntryList<int> times;
+    };
+
+    std::vector<Answer> serial(roots.size());
+    for (std::size_t query = 0; query < roots.size(); ++query) {
+        serial[query].bfs = digraph.BreadthFirstSearch(roots[query]);
+        serial[query].dfs = digraph.DepthFirstSearch(roots[query]);
+        serial[query].times = digraph.GetEntryTimes();
+        serial[query].dijkstra = digraph.DjikstaShortestPath(roots[query]);
+        serial[query].parents = digraph.GetParents();
+    }
+
+    // Each thread owns one context; the graph itself is only read
+    const Graphis<int>& shared = digraph;
+    std::vector<Answer> concurrent(roots.size());
+    std::vector<std::thread> threads;
+    for (std::size_t query = 0; query < roots.size(); ++query) {
+        threads.emplace_back([&, query]() {
+            SearchContext<int> search;
+            for (int repeat = 0; repeat < 3; ++repeat) {
+                concurrent[query].bfs = shared.BreadthFirstSearch(roots[query], search);
+                concurrent[query].dfs = shared.DepthFirstSearch(roots[query], search);
+                concurrent[query].times = shared.GetEntryTimes(search);
+                concurrent[query].dijkstra = shared.DjikstaShortestPath(roots[query], search);
+                concurrent[query].parents = shared.GetParents(search);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (std::size_t query = 0; query < roots.size(); ++query) {
+        EXPECT_EQ(serial[query].bfs, concurrent[query].bfs);
+        EXPECT_EQ(serial[query].dfs, concurrent[query].dfs);
+        EXPECT_EQ(serial[query].times, concurrent[query].times);
+        EXPECT_EQ(serial[query].dijkstra, concurrent[query].dijkstra);
+        EXPECT_EQ(serial[query].parents, concurrent[query].parents);
+    }
+
+    // The graph's own state is untouched by the context queries
+    std::stack<int> path;
+    SearchContext<int> search;
+    shared.DjikstaShortestPath(0, search, QueueKind::QK_RADIX_HEAP);
+    shared.FindPath(0, serial.front().dijkstra.back(), path, search);
+    EXPECT_EQ(serial.back().parents, digraph.GetParents());
+    EXPECT_LT(1, path.size());
+    EXPECT_EQ(0, path.top());
+}
+
+/// \struct ClassifyingVisitor
+/// \brief  Stateful counterpart of RecordEdgeClassification, with no globals
+struct ClassifyingVisitor : TraversalVisitor<int> {
+    ClassifyingVisitor(const Graphis<int>& graph, const SearchContext<int>& search)
+            : graph(graph), search(search) {}
+
+    void Edge(const int& v1, const int& v2) {
+        classifications.push_back(graph.GetEdgeClassification(v1, v2, search));
+    }
+
+    const Graphis<int>& graph;
+    const SearchContext<int>& search;
+    std::vector<EdgeClassification> classifications;
+};
+
+/// \test   VisitorsShouldMatchFunctionPointerHooks
+TEST_F(GraphisTest, VisitorsShouldMatchFunctionPointerHooks) {
+    LoadSearchGraph();
+    g_classifications.clear();
+    graph2.SetProcessEdgeFn(RecordEdgeClassification);
+    std::vector<int> expected = graph2.DepthFirstSearch(0);
+
+    SearchContext<int> search;
+    ClassifyingVisitor classifier(graph2, search);
+    EXPECT_THAT(expected, ::testing::Eq(graph2.DepthFirstSearch(0, search, classifier)));
+    EXPECT_THAT(g_classifications, ::testing::Eq(classifier.classifications));
+    EXPECT_EQ(graph2.GetEntryTimes(), graph2.GetEntryTimes(search));
+
+    // Lambdas: early and late hooks bracket every vertex, and the search stops on request
+    std::vector<int> early;
+    std::vector<int> late;
+    int edges = 0;
+    auto visitor = MakeVisitor([&](int vert) { early.push_back(vert); },
+                               [&](int, int) { ++edges; },
+                               [&](int vert) { late.push_back(vert); });
+    std::vector<int> bfs = graph2.BreadthFirstSearch(0, search, visitor);
+    EXPECT_THAT(bfs, ::testing::Eq(early));
+    EXPECT_THAT(bfs, ::testing::Eq(late));
+    EXPECT_LT(0, edges);
+
+    early.clear();
+    std::vector<int> dfs = graph2.DepthFirstSearch(
+            0,
+            search,
+            MakeVisitor(
+                    [&](int vert) {
+                        early.push_back(vert);
+                        search.SetTerminationFlag(early.size() == 2);
+                    },
+                    [](int, int) {},
+                    [](int) {}));
+    EXPECT_THAT(dfs, ::testing::ElementsAre(0, 2));
+    EXPECT_TRUE(search.IsTerminated());
+}
+
+/// \test   RemoveEdgeAndSetEdgeWeightShouldKeepCounts
+TEST_F(GraphisTest, RemoveEdgeAndSetEdgeWeightShouldKeepCounts) {
+    LoadSearchGraph();
+    int num_edges = graph2.GetNumEdges();
+
+    graph2.SetEdgeWeight(0, 1, 9);
+    EXPECT_EQ(9, graph2.ShortestPath(0, 1).distance);
+    EXPECT_THROW(graph2.SetEdgeWeight(1, 3, 9), std::invalid_argument);
+
+    EXPECT_TRUE(graph2.RemoveEdge(0, 1));
+    EXPECT_FALSE(graph2.RemoveEdge(0, 1));
+    EXPECT_FALSE(graph2.RemoveEdge(0, 42));
+    EXPECT_EQ(num_edges - 1, graph2.GetNumEdges());
+    EXPECT_THAT(graph2.GetAdjacentVertices(0), ::testing::ElementsAre(2));
+
+    LoadRouteGraph();
+    num_edges = allegiant.GetNumEdges();
+    allegiant.SetEdgeWeight("LAX", "BLI", 1);
+    EXPECT_EQ(1, allegiant.ShortestPath("BLI", "LAX").distance);
+    EXPECT_TRUE(allegiant.RemoveEdge("BLI", "LAX"));
+    EXPECT_EQ(num_edges - 2, allegiant.GetNumEdges());
+    EXPECT_EQ(764 + 445 + 748, allegiant.ShortestPath("BLI", "LAX").distance);
+
+    // Tombstones carry kNoVertex, which an unknown destination must not match
+    digraph.SetCompactionThreshold(1.0);
+    digraph.AddEdge(1, 2);
+    digraph.AddEdge(1, 3);
+    EXPECT_TRUE(digraph.RemoveEdge(1, 3));
+    EXPECT_THROW(digraph.SetEdgeWeight(1, 99, 7), std::invalid_argument);
+    EXPECT_EQ(1, digraph.GetNumEdges());
+}
+
+/// \test   DynamicShortestPathShouldMatchRecomputation
+TEST_F(GraphisTest, DynamicShortestPathShouldMatchRecomputation) {
+    for (Graphis<int>* graph : {&digraph, &sparse}) {
+        LoadRandomGraph(*graph, 500, 2500);
+        DynamicShortestPath<int> dynamic(*graph, 0);
+
+        std::mt19937 rng(20200518);
+        std::uniform_int_distribution<int> any(0, 509);
+        std::uniform_int_distribution<int> weight(1, 100);
+        std::size_t touched = 0;
+        for (int update = 0; update < 300; ++update) {
+            int src = any(rng) % 500;
+            std::vector<int> dests = graph->GetAdjacentVertices(src);
+            if ((update % 3 == 0) || dests.empty()) {
+                touched += dynamic.AddEdge(src, any(rng), weight(rng));
+            } else if (update % 3 == 1) {
+                touched += dynamic.SetEdgeWeight(src, dests[0], weight(rng));
+            } else {
+                touched += dynamic.RemoveEdge(src, dests[0]);
+            }
+
+            DynamicShortestPath<int> fresh(*graph, 0);
+            for (auto vert : graph->GetVertexList()) {
+                ASSERT_EQ(fresh.GetDistance(vert), dynamic.GetDistance(vert)) << update;
+            }
+        }
+
+        EXPECT_EQ(300, dynamic.GetStats().num_updates);
+        EXPECT_EQ(touched, dynamic.GetStats().total_touched);
+        EXPECT_LT(touched, 300 * 500 / 10);
+
+        std::stack<int> path;
+        int end = graph->GetVertexList().back();
+        dynamic.FindPath(end, path);
+        EXPECT_EQ(graph->ShortestPath(0, end).distance, dynamic.GetDistance(end));
+        EXPECT_EQ(0, path.top());
+    }
+
+    EXPECT_THROW(DynamicShortestPath<int>(digraph, 12345), std::invalid_argument);
+    DynamicShortestPath<int> dynamic(digraph, 0);
+    EXPECT_THROW(dynamic.AddEdge(0, 1, -1), std::invalid_argument);
+    EXPECT_THROW(dynamic.SetEdgeWeight(12345, 0, 1), std::invalid_argument);
+    EXPECT_THROW(dynamic.SetEdgeWeight(0, 12345, 1), std::invalid_argument);
+}
+
+/// \test   RemoveVertexShouldTombstoneAndCompact
+TEST_F(GraphisTest, RemoveVertexShouldTombstoneAndCompact) {
+    auto frozen_neighbors = [](const GraphisCSR<int>& frozen, int key) {
+        std::vector<int> neighbors;
+        VertexId vert = frozen.FindId(key);
+        for (auto edge = frozen.GetOffsets()[vert]; edge < frozen.GetOffsets()[vert + 1]; ++edge) {
+            neighbors.push_back(frozen.GetKey(frozen.GetTargets()[edge]));
+        }
+
+        return neighbors;
+    };
+
+    LoadSearchGraph();
+    graph2.SetCompactionThreshold(1.0);
+    int num_edges = graph2.GetNumEdges();
+
+    // 0->2 and 1->2 come in, 2->0 and 2->3 go out
+    EXPECT_TRUE(graph2.RemoveVertex(2));
+    EXPECT_FALSE(graph2.RemoveVertex(2));
+    EXPECT_EQ(num_edges - 4, graph2.GetNumEdges());
+    EXPECT_EQ(4, graph2.GetNumTombstones());
+    EXPECT_THAT(graph2.GetVertexList(), ::testing::ElementsAre(0, 1, 3));
+    EXPECT_THAT(graph2.GetAdjacentVertices(0), ::testing::ElementsAre(1));
+    EXPECT_TRUE(graph2.GetNeighbors(1).empty());
+    EXPECT_THAT(graph2.DepthFirstSearch(0), ::testing::ElementsAre(0, 1));
+    EXPECT_THAT(frozen_neighbors(graph2.Freeze(), 0), ::testing::ElementsAre(1));
+
+    graph2.AddEdge(3, 2);
+    graph2.Compact();
+    EXPECT_EQ(0, graph2.GetNumTombstones());
+    EXPECT_EQ(num_edges - 3, graph2.GetNumEdges());
+    EXPECT_THAT(graph2.GetVertexList(), ::testing::ElementsAre(0, 1, 2, 3));
+    EXPECT_THAT(graph2.GetAdjacentVertices(3), ::testing::ElementsAre(2, 3));
+    EXPECT_THAT(graph2.BreadthFirstSearch(0), ::testing::ElementsAre(0, 1));
+
+    // Undirected: the neighbors lose their arcs back, and the purge runs past the threshold
+    LoadRandomGraph(sparse, 200, 1000);
+    num_edges = sparse.GetNumEdges();
+    int degree = static_cast<int>(sparse.GetAdjacentVertices(0).size());
+    std::vector<int> before = sparse.GetVertexList();
+    std::vector<int> neighbors = sparse.GetAdjacentVertices(5);
+    EXPECT_TRUE(sparse.RemoveVertex(0));
+    EXPECT_EQ(num_edges - 2 * degree, sparse.GetNumEdges());
+    EXPECT_THAT(neighbors, ::testing::Eq(sparse.GetAdjacentVertices(5)));
+    for (auto vert : sparse.GetVertexList()) {
+        EXPECT_THAT(sparse.GetAdjacentVertices(vert), ::testing::Not(::testing::Contains(0)));
+    }
+
+    for (int vert = 1; vert < 8; ++vert) {
+        sparse.RemoveVertex(vert);
+    }
+
+    EXPECT_GT(0.25 * (sparse.GetNumTombstones() + sparse.GetNumEdges()),
+              sparse.GetNumTombstones());
+    before.erase(before.begin(), before.begin() + 8);
+    EXPECT_THAT(sparse.GetVertexList(), ::testing::Eq(before));
+    GraphisCSR<int> frozen = sparse.Freeze();
+    EXPECT_EQ(sparse.GetNumEdges(), frozen.GetNumEdges());
+    sparse.Compact();
+    EXPECT_THAT(sparse.GetVertexList(), ::testing::Eq(before));
+    for (auto vert : before) {
+        EXPECT_THAT(sparse.GetAdjacentVertices(vert),
+                    ::testing::ElementsAreArray(frozen_neighbors(frozen, vert)));
+    }
+}
+
+/// \test   AllPairsShortestPathsShouldMatchPointQueries
+TEST_F(GraphisTest, AllPairsShortestPathsShouldMatchPointQueries) {
+    LoadRandomGraph(digraph, 300, 1500);
+    GraphisCSR<int> frozen = digraph.Freeze();
+    const auto& keys = frozen.GetVertexList();
+
+    DistanceMatrix johnson = frozen.AllPairsShortestPaths(AllPairsKind::AK_JOHNSON, 3);
+    DistanceMatrix floyd = frozen.AllPairsShortestPaths(AllPairsKind::AK_FLOYD_WARSHALL, 3);
+    ASSERT_EQ(keys.size(), johnson.GetNumVerts());
+    EXPECT_TRUE(std::equal(johnson.GetData(),
+                           johnson.GetData() + keys.size() * keys.size(),
+                           floyd.GetData()));
+    DistanceMatrix serial = frozen.AllPairsShortestPaths(AllPairsKind::AK_JOHNSON, 1);
+    EXPECT_TRUE(std::equal(johnson.GetRow(0), johnson.GetRow(keys.size()), serial.GetData()));
+
+    for (std::size_t src = 0; src < keys.size(); src += 37) {
+        for (std::size_t dst = 0; dst < keys.size(); ++dst) {
+            ASSERT_EQ(digraph.ShortestPath(keys[src], keys[dst]).distance, johnson.At(src, dst));
+        }
+    }
+
+    // Negative arcs are fine without a negative cycle
+    graph2.SetDirected(true);
+    graph2.AddEdge(0, 1, 4);
+    graph2.AddEdge(0, 2, 1);
+    graph2.AddEdge(2, 1, -3);
+    graph2.AddEdge(1, 3, 2);
+    for (auto kind : {AllPairsKind::AK_JOHNSON, AllPairsKind::AK_FLOYD_WARSHALL}) {
+        DistanceMatrix distances = graph2.Freeze().AllPairsShortestPaths(kind);
+        EXPECT_THAT(std::vector<int>(distances.GetRow(0), distances.GetRow(1)),
+                    ::testing::ElementsAre(0, -2, 1, 0));
+        EXPECT_EQ(kUnreachable, distances.At(3, 0));
+        EXPECT_EQ(-3, distances.At(2, 1));
+    }
+
+    graph2.AddEdge(3, 2, 0);
+    EXPECT_THROW(graph2.Freeze().AllPairsShortestPaths(AllPairsKind::AK_JOHNSON),
+                 std::runtime_error);
+    EXPECT_THROW(graph2.Freeze().AllPairsShortestPaths(AllPairsKind::AK_FLOYD_WARSHALL),
+                 std::runtime_error);
+}
+
+/// \test   DeltaSteppingShouldMatchDijkstra
+TEST_F(GraphisTest, DeltaSteppingShouldMatchDijkstra) {
+    for (Graphis<int>* graph : {&digraph, &sparse}) {
+        LoadRandomGraph(*graph, 3000, 15000);
+        graph->AddEdge(0, 2999, 0);
+        graph->AddEdge(2999, 0, 0);
+        DynamicShortestPath<int> dijkstra(*graph, 0);
+        std::vector<int> vertices = graph->GetVertexList();
+
+        for (int delta : {0, 1, 30, 1000}) {
+            for (unsigned num_threads : {1u, 4u}) {
+                SearchContext<int> search;
+                std::vector<int> distances =
+                        graph->DeltaSteppingShortestPath(0, search, delta, num_threads);
+                ASSERT_EQ(vertices.size(), distances.size());
+                for (std::size_t slot = 0; slot < vertices.size(); ++slot) {
+                    ASSERT_EQ(dijkstra.GetDistance(vertices[slot]), distances[slot]);
+                }
+
+                // Every recorded path is as long as the distance it ends at
+                for (std::size_t slot = 0; slot < vertices.size(); slot += 97) {
+                    if (distances[slot] == kUnreachable) {
+                        continue;
+                    }
+
+                    std::stack<int> path;
+                    graph->FindPath(0, vertices[slot], path, search);
+                    std::vector<int> hops;
+                    for (; !path.empty(); path.pop()) {
+                        hops.push_back(path.top());
+                    }
+
+                    int length = 0;
+                    for (std::size_t hop = 1; hop < hops.size(); ++hop) {
+                        int cheapest = kUnreachable;
+                        for (const auto& neighbor : graph->GetNeighbors(hops[hop - 1])) {
+                            if (neighbor.dest == hops[hop]) {
+                                cheapest = std::min(cheapest, neighbor.weight);
+                            }
+                        }
+
+                        length += cheapest;
+                    }
+
+                    EXPECT_EQ(distances[slot], length);
+                }
+            }
+        }
+    }
+
+    // The non-const form leaves its parents for FindPath
+    LoadSearchGraph();
+    EXPECT_THAT(graph2.DeltaSteppingShortestPath(0), ::testing::ElementsAre(0, 0, 0, 0));
+    std::stack<int> path;
+    graph2.FindPath(0, 3, path);
+    EXPECT_EQ(3, path.size());
+    EXPECT_THROW(graph2.DeltaSteppingShortestPath(42), std::invalid_argument);
+
+    // The default delta (max weight * V / E) would overflow int here
+    Graphis<int> heavy(true);
+    heavy.AddEdge(0, 1, 2000000000);
+    heavy.AddEdge(2, 3, 1);
+    EXPECT_EQ(2000000000, heavy.DeltaSteppingShortestPath(0)[1]);
+}
+
+/// \test   PageRankShouldConserveRank
+TEST_F(GraphisTest, PageRankShouldConserveRank) {
+    // A directed cycle is symmetric, so every vertex ends where it started
+    for (int vert = 0; vert < 5; ++vert) {
+        digraph.AddEdge(vert, (vert + 1) % 5);
+    }
+
+    int iterations = 0;
+    std::vector<double> ranks = PageRank(digraph.Freeze(), 0.85, 1e-9, 100, &iterations);
+    EXPECT_EQ(1, iterations);
+    for (auto rank : ranks) {
+        EXPECT_NEAR(0.2, rank, 1e-12);
+    }
+
+    // Vertices without out-edges give their rank to everyone instead of leaking it
+    LoadRandomGraph(sparse, 2000, 3000);
+    Graphis<int> random(true);
+    LoadRandomGraph(random, 2000, 6000);
+    for (Graphis<int>* graph : {&random, &sparse}) {
+        GraphisCSR<int> frozen = graph->Freeze();
+        std::vector<double> serial = PageRank(frozen, 0.85, 1e-10, 200, &iterations, 1);
+        EXPECT_LT(iterations, 200);
+        EXPECT_NEAR(1.0, std::accumulate(serial.begin(), serial.end(), 0.0), 1e-9);
+
+        std::vector<double> parallel = PageRank(frozen, 0.85, 1e-10, 200, nullptr, 4);
+        for (std::size_t vert = 0; vert < serial.size(); ++vert) {
+            ASSERT_NEAR(serial[vert], parallel[vert], 1e-12);
+        }
+    }
+
+    // The hubs that source every fourth edge have the largest degree
+    GraphisCSR<int> frozen = random.Freeze();
+    std::vector<double> degrees = DegreeCentrality(frozen);
+    EXPECT_GT(degrees[0], degrees[1000]);
+    EXPECT_NEAR(2.0 * frozen.GetNumEdges() / (frozen.GetNumVerts() - 1),
+                std::accumulate(degrees.begin(), degrees.end(), 0.0),
+                1e-9);
+}
+
+/// \test   BetweennessCentralityShouldCountShortestPaths
+TEST_F(GraphisTest, BetweennessCentralityShouldCountShortestPaths) {
+    for (int vert = 0; vert < 4; ++vert) {
+        sparse.AddEdge(vert, vert + 1);
+    }
+
+    EXPECT_THAT(BetweennessCentrality(sparse.Freeze()), ::testing::ElementsAre(0, 3, 4, 3, 0));
+
+    // Two equally short routes split the credit
+    digraph.AddEdge(0, 1);
+    digraph.AddEdge(0, 2);
+    digraph.AddEdge(1, 3);
+    digraph.AddEdge(2, 3);
+    EXPECT_THAT(BetweennessCentrality(digraph.Freeze()),
+                ::testing::ElementsAre(0, 0.5, 0.5, 0));
+
+    Graphis<int> random(true);
+    LoadRandomGraph(random, 500, 2000);
+    GraphisCSR<int> frozen = random.Freeze();
+    std::vector<double> exact = BetweennessCentrality(frozen, 1);
+    std::vector<double> parallel = BetweennessCentrality(frozen, 4);
+    std::vector<double> sampled = BetweennessCentrality(frozen, 4, frozen.GetNumVerts());
+    for (std::size_t vert = 0; vert < exact.size(); ++vert) {
+        ASSERT_NEAR(exact[vert], parallel[vert], 1e-6);
+        ASSERT_NEAR(exact[vert], sampled[vert], 1e-6);
+    }
+}
+
+/// \test   StronglyConnectedComponentsShouldMatchReachability
+TEST_F(GraphisTest, StronglyConnectedComponentsShouldMatchReachability) {
+    // {1, 2, 5}, {3, 4, 8}, {6, 7}, plus a self-loop that joins nothing
+    for (auto edge : std::vector<std::pair<int, int>>{
+                 {1, 2}, {2, 3}, {2, 5}, {2, 6}, {3, 4}, {3, 7}, {4, 3}, {4, 8},
+                 {5, 1}, {5, 6}, {6, 7}, {7, 6}, {8, 4}, {8, 7}, {9, 9}}) {
+        digraph.AddEdge(edge.first, edge.second, edge.first + edge.second);
+    }
+
+    GraphisCSR<int> frozen = digraph.Freeze();
+    for (auto kind : {StrongKind::SC_TARJAN, StrongKind::SC_FORWARD_BACKWARD}) {
+        GraphisCSR<int> dag;
+        EXPECT_THAT(frozen.StronglyConnectedComponents(kind, &dag),
+                    ::testing::ElementsAre(0, 0, 1, 1, 0, 2, 2, 1, 3));
+        EXPECT_EQ(4, dag.GetNumVerts());
+        EXPECT_THAT(dag.GetOffsets(), ::testing::ElementsAre(0, 2, 3, 3, 3));
+        EXPECT_THAT(dag.GetTargets(), ::testing::ElementsAre(1, 2, 2));
+        EXPECT_THAT(dag.GetWeights(), ::testing::ElementsAre(5, 8, 10));
+    }
+
+    // Brute force: two vertices share a component exactly when each reaches the other
+    Graphis<int> random(true);
+    LoadRandomGraph(random, 300, 450);
+    frozen = random.Freeze();
+    std::vector<int> vertices = frozen.GetVertexList();
+    std::vector<std::vector<bool>> reaches;
+    for (auto vert : vertices) {
+        std::vector<bool> reached(vertices.size(), false);
+        for (auto seen : frozen.BreadthFirstSearch(vert)) {
+            reached[frozen.FindId(seen)] = true;
+        }
+
+        reaches.push_back(reached);
+    }
+
+    std::vector<int> tarjan = frozen.StronglyConnectedComponents();
+    for (std::size_t src = 0; src < vertices.size(); ++src) {
+        for (std::size_t dst = 0; dst < vertices.size(); ++dst) {
+            ASSERT_EQ(reaches[src][dst] && reaches[dst][src], tarjan[src] == tarjan[dst]);
+        }
+    }
+
+    // Large enough that forward-backward splits its giant component across the team
+    LoadRandomGraph(random, 20000, 50000);
+    frozen = random.Freeze();
+    GraphisCSR<int> dag;
+    tarjan = frozen.StronglyConnectedComponents(StrongKind::SC_TARJAN, &dag);
+    for (unsigned num_threads : {1u, 4u}) {
+        EXPECT_EQ(tarjan,
+                  frozen.StronglyConnectedComponents(
+                          StrongKind::SC_FORWARD_BACKWARD, nullptr, num_threads));
+    }
+
+    std::vector<int> order = dag.TopologicalSort();
+    std::vector<std::size_t> position(order.size());
+    for (std::size_t slot = 0; slot < order.size(); ++slot) {
+        position[order[slot]] = slot;
+    }
+
+    for (VertexId src = 0; src < dag.GetNumVerts(); ++src) {
+        for (auto edge = dag.GetOffsets()[src]; edge < dag.GetOffsets()[src + 1]; ++edge) {
+            ASSERT_LT(position[src], position[dag.GetTargets()[edge]]);
+        }
+    }
+}
+
+/// \test   TopologicalLevelsShouldGroupIndependentVertices
+TEST_F(GraphisTest, TopologicalLevelsShouldGroupIndependentVertices) {
+    LoadDAG();
+    dag.AddEdge('H', 'D');
+    dag.AddEdge('H', 'C');
+    using Level = std::vector<char>;
+    EXPECT_THAT(dag.Freeze().TopologicalLevels(),
+                ::testing::ElementsAre(Level{'G', 'H'},
+                                       Level{'A'},
+                                       Level{'B'},
+                                       Level{'C'},
+                                       Level{'F'},
+                                       Level{'E'},
+                                       Level{'D'}));
+
+    // Every edge of a random DAG climbs at least one level, whatever the thread count
+    Graphis<int> random(true);
+    std::mt19937 rng(20200518);
+    std::uniform_int_distribution<int> any(0, 4999);
+    for (int edge = 0; edge < 20000; ++edge) {
+        int src = any(rng);
+        int dst = any(rng);
+        if (src != dst) {
+            random.AddEdge(std::min(src, dst), std::max(src, dst));
+        }
+    }
+
+    GraphisCSR<int> frozen = random.Freeze();
+    std::vector<std::vector<int>> levels = frozen.TopologicalLevels(nullptr, 1);
+    EXPECT_EQ(levels, frozen.TopologicalLevels(nullptr, 4));
+
+    std::vector<std::size_t> level_of(frozen.GetNumVerts());
+    std::size_t num_sorted = 0;
+    for (std::size_t level = 0; level < levels.size(); ++level) {
+        for (auto vert : levels[level]) {
+            level_of[frozen.FindId(vert)] = level;
+            ++num_sorted;
+        }
+    }
+
+    EXPECT_EQ(frozen.GetNumVerts(), num_sorted);
+    for (VertexId src = 0; src < frozen.GetNumVerts(); ++src) {
+        for (auto edge = frozen.GetOffsets()[src]; edge < frozen.GetOffsets()[src + 1]; ++edge) {
+            ASSERT_LT(level_of[src], level_of[frozen.GetTargets()[edge]]);
+        }
+    }
+
+    // A cycle blocks itself and everything downstream of it
+    dag.AddEdge('D', 'B');
+    std::vector<char> cycle;
+    EXPECT_THAT(dag.Freeze().TopologicalLevels(&cycle),
+                ::testing::ElementsAre(Level{'G', 'H'}, Level{'A'}));
+    EXPECT_THAT(cycle, ::testing::ElementsAre('D', 'B'));
+    EXPECT_THROW(dag.Freeze().TopologicalLevels(), std::runtime_error);
+    EXPECT_THROW(sparse.Freeze().TopologicalLevels(), std::invalid_argument);
+}
+
+/// \test   MultiSourceBreadthFirstSearchShouldMatchSingleSource
+TEST_F(GraphisTest, MultiSourceBreadthFirstSearchShouldMatchSingleSource) {
+    Graphis<int> random(true);
+    LoadRandomGraph(random, 2000, 5000);
+    LoadRandomGraph(sparse, 2000, 2500);
+    for (Graphis<int>* graph : {&random, &sparse}) {
+        GraphisCSR<int> frozen = graph->Freeze();
+        std::vector<int> vertices = frozen.GetVertexList();
+
+        // More roots than one batch holds, some of them repeated
+        std::vector<int> roots;
+        for (std::size_t slot = 0; slot < 300; ++slot) {
+            roots.push_back(vertices[slot * 7 % vertices.size()]);
+        }
+
+        roots[299] = roots[0];
+        std::vector<std::vector<int>> wide = frozen.MultiSourceBreadthFirstSearch(roots, 1);
+        EXPECT_EQ(wide, frozen.MultiSourceBreadthFirstSearch<64>(roots, 4));
+        ASSERT_EQ(roots.size(), wide.size());
+        for (std::size_t slot = 0; slot < roots.size(); ++slot) {
+            // Level by level in key order, like ParallelBreadthFirstSearch
+            ASSERT_EQ(frozen.ParallelBreadthFirstSearch(roots[slot], nullptr, 1), wide[slot]);
+
+            std::vector<int> bfs = frozen.BreadthFirstSearch(roots[slot]);
+            std::sort(bfs.begin(), bfs.end());
+            std::sort(wide[slot].begin(), wide[slot].end());
+            ASSERT_EQ(bfs, wide[slot]);
+        }
+    }
+
+    EXPECT_TRUE(sparse.Freeze().MultiSourceBreadthFirstSearch({}).empty());
+    EXPECT_THROW(sparse.Freeze().MultiSourceBreadthFirstSearch({-1}), std::invalid_argument);
+}
+
+/// \test   ReorderShouldKeepTheGraphAndImproveLocality
+TEST_F(GraphisTest, ReorderShouldKeepTheGraphAndImproveLocality) {
+    // Rings of 16 neighbors whose keys are scattered, so key order puts neighbors far apart
+    const int num_vertices = 4096;
+    std::vector<int> keys(num_vertices);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(20200518));
+    Graphis<int> rings(true);
+    for (int vert = 0; vert < num_vertices; ++vert) {
+        int ring = vert / 16 * 16;
+        rings.AddEdge(keys[vert], keys[ring + (vert + 1) % 16], vert % 7);
+        rings.AddEdge(keys[vert], keys[ring + (vert + 5) % 16], vert % 3);
+    }
+
+    GraphisCSR<int> frozen = rings.Freeze();
+    LocalityStats before = frozen.GetLocality();
+    EXPECT_TRUE(frozen.IsKeyOrdered());
+
+    for (auto kind : {ReorderKind::RK_DEGREE,
+                      ReorderKind::RK_REVERSE_CUTHILL_MCKEE,
+                      ReorderKind::RK_GORDER}) {
+        // Every vertex has the same degree, so the stable degree sort changes nothing
+        GraphisCSR<int> reordered = frozen.Reorder(kind);
+        EXPECT_EQ(kind == ReorderKind::RK_DEGREE, reordered.IsKeyOrdered());
+        ASSERT_EQ(frozen.GetNumEdges(), reordered.GetNumEdges());
+
+        // Same keys, and every key keeps its arcs in order
+        for (VertexId vert = 0; vert < frozen.GetNumVerts(); ++vert) {
+            VertexId moved = reordered.FindId(frozen.GetKey(vert));
+            ASSERT_EQ(frozen.GetKey(vert), reordered.GetKey(moved));
+            auto edge = frozen.GetOffsets()[vert];
+            auto moved_edge = reordered.GetOffsets()[moved];
+            ASSERT_EQ(frozen.GetOffsets()[vert + 1] - edge,
+                      reordered.GetOffsets()[moved + 1] - moved_edge);
+            for (; edge < frozen.GetOffsets()[vert + 1]; ++edge, ++moved_edge) {
+                ASSERT_EQ(frozen.GetKey(frozen.GetTargets()[edge]),
+                          reordered.GetKey(reordered.GetTargets()[moved_edge]));
+                ASSERT_EQ(frozen.GetWeights()[edge], reordered.GetWeights()[moved_edge]);
+            }
+        }
+
+        EXPECT_EQ(kNoVertex, reordered.FindId(-1));
+        EXPECT_EQ(frozen.ParallelBreadthFirstSearch(keys[0]).size(),
+                  reordered.ParallelBreadthFirstSearch(keys[0]).size());
+        if (kind != ReorderKind::RK_DEGREE) {
+            std::ostringstream out;
+            EXPECT_THROW(MappedGraphis<int>::Save(reordered, out), std::invalid_argument);
+            EXPECT_THROW(ContractionHierarchy<int>{reordered}, std::invalid_argument);
+            LocalityStats after = reordered.GetLocality();
+            EXPECT_LT(after.average_gap * 10, before.average_gap);
+            EXPECT_LT(after.average_log_gap, before.average_log_gap);
+            EXPECT_GT(after.near_fraction, 0.5);
+        }
+    }
+
+    // Hubs first, by degree in both directions
+    Graphis<int> random(true);
+    LoadRandomGraph(random, 1000, 4000);
+    GraphisCSR<int> by_degree = random.Freeze().Reorder(ReorderKind::RK_DEGREE);
+    const auto& offsets = by_degree.GetOffsets();
+    const auto& in_offsets = by_degree.GetInOffsets();
+    for (VertexId vert = 1; vert < by_degree.GetNumVerts(); ++vert) {
+        ASSERT_GE(offsets[vert] - offsets[vert - 1] + in_offsets[vert] - in_offsets[vert - 1],
+                  offsets[vert + 1] - offsets[vert] + in_offsets[vert + 1] - in_offsets[vert]);
+    }
+
+    // Reordering twice still finds every key
+    GraphisCSR<int> twice = frozen.Reorder(ReorderKind::RK_GORDER)
+                                    .Reorder(ReorderKind::RK_REVERSE_CUTHILL_MCKEE);
+    for (auto key : keys) {
+        ASSERT_EQ(key, twice.GetKey(twice.FindId(key)));
+    }
+}
+
 ///
 int main(int argc, char** argv) {
     testing::InitGoogleTest(&argc, argv);
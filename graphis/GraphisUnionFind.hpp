@@ -0,0 +1,84 @@
+/*! -------------------------------------------------------------------------*\
+|   Lock-free disjoint sets over dense vertex ids
+|   \see https://en.wikipedia.org/wiki/Disjoint-set_data_structure#Concurrency
+|   \see https://doi.org/10.1109/IPDPS.2018.00042 (Afforest)
+\*---------------------------------------------------------------------------*/
+#pragma once
+
+#include "Graphis.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+/// \class  ConcurrentUnionFind
+/// \brief  Disjoint sets of the ids 0..size-1 that any number of threads may Find and Unite at
+///         once. Roots are only ever linked to smaller roots with a compare-and-swap, so every
+///         set's root is its smallest member, and Find halves paths as it walks them.
+class ConcurrentUnionFind {
+public:
+    ///
+    explicit ConcurrentUnionFind(std::size_t size) : m_parents(size) {
+        for (std::size_t vert = 0; vert < size; ++vert) {
+            m_parents[vert].store(static_cast<VertexId>(vert), std::memory_order_relaxed);
+        }
+    }
+
+    ///
+    /// \brief  Returns the root of vert's set, pointing each visited id at its grandparent
+    VertexId Find(VertexId vert) {
+        for (;;) {
+            VertexId parent = m_parents[vert].load(std::memory_order_acquire);
+            VertexId grandparent = m_parents[parent].load(std::memory_order_acquire);
+            if (parent == grandparent) {
+                return parent;
+            }
+
+            m_parents[vert].compare_exchange_weak(parent, grandparent);
+            vert = grandparent;
+        }
+    }
+
+    ///
+    /// \brief  Points every id straight at its root; not safe to run alongside Unite. Parents
+    ///         never exceed their children, so one ascending pass suffices.
+    void Flatten() {
+        for (std::size_t vert = 0; vert < m_parents.size(); ++vert) {
+            VertexId root = m_parents[m_parents[vert].load(std::memory_order_relaxed)].load(
+                    std::memory_order_relaxed);
+            m_parents[vert].store(root, std::memory_order_relaxed);
+        }
+    }
+
+    ///
+    /// \brief  Root of vert's set without compressing; exact only after Flatten
+    VertexId GetParent(VertexId vert) const {
+        return m_parents[vert].load(std::memory_order_relaxed);
+    }
+
+    ///
+    std::size_t Size() const {
+        return m_parents.size();
+    }
+
+    ///
+    /// \brief  Merges the sets holding v1 and v2; returns false if they were already one set
+    bool Unite(VertexId v1, VertexId v2) {
+        for (;;) {
+            v1 = Find(v1);
+            v2 = Find(v2);
+            if (v1 == v2) {
+                return false;
+            }
+
+            VertexId high = std::max(v1, v2);
+            VertexId low = std::min(v1, v2);
+            if (m_parents[high].compare_exchange_strong(high, low)) {
+                return true;
+            }
+        }
+    }
+
+private:
+    std::vector<std::atomic<VertexId>> m_parents;
+};